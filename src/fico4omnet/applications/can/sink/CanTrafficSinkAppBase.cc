@@ -28,22 +28,29 @@
 
 #include "fico4omnet/applications/can/sink/CanTrafficSinkAppBase.h"
 
-#include "fico4omnet/linklayer/can/messages/CanDataFrame_m.h"
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
 #include "fico4omnet/buffer/can/CanInputBuffer.h"
+#include "fico4omnet/utilities/HelperFunctions.h"
 
 namespace FiCo4OMNeT {
 
 Define_Module(CanTrafficSinkAppBase);
 
-void CanTrafficSinkAppBase::initialize() {
-    idle = true;
-    currentFrameID = 0;
-    bufferMessageCounter = 0;
+void CanTrafficSinkAppBase::initialize(int stage) {
+    if (stage == 0) {
+        idle = true;
+        currentFrameID = 0;
+        bufferMessageCounter = 0;
+        inputBuffer = nullptr;
+        workTime = par("workTime").doubleValue();
 
-    rxDFSignal = registerSignal("rxDF");
-    rxRFSignal = registerSignal("rxRF");
-    rxDFPayloadSignal = registerSignal("rxDFPayload");
-    rxRFPayloadSignal = registerSignal("rxRFPayload");
+        rxDFSignal = registerSignal("rxDF");
+        rxRFSignal = registerSignal("rxRF");
+        rxDFPayloadSignal = registerSignal("rxDFPayload");
+        rxRFPayloadSignal = registerSignal("rxRFPayload");
+    } else if (stage == 1) {
+        inputBuffer = resolveModule<CanInputBuffer>(getParentModule()->getSubmodule("bufferIn"), "bufferIn", this);
+    }
 }
 
 void CanTrafficSinkAppBase::handleMessage(cMessage *msg) {
@@ -58,15 +65,15 @@ void CanTrafficSinkAppBase::handleMessage(cMessage *msg) {
         bufferMessageCounter--;
         if (frame->getRtr()) {
             emit(rxRFSignal, frame);
-            emit(rxRFPayloadSignal, frame->getEncapsulatedPacket());
+            //the payload is shared with the other receivers, listeners only read it
+            emit(rxRFPayloadSignal, const_cast<cPacket*>(frame->getPayload()));
         } else {
             emit(rxDFSignal, frame);
-            emit(rxDFPayloadSignal, frame->getEncapsulatedPacket());
+            emit(rxDFPayloadSignal, const_cast<cPacket*>(frame->getPayload()));
         }
-        startWorkOnFrame(0);
+        startWorkOnFrame(workTime);
     } else if (msg->isSelfMessage()) {
-        CanInputBuffer *buffer = dynamic_cast<CanInputBuffer*> (getParentModule()->getSubmodule("bufferIn"));
-        buffer->deleteFrame(currentFrameID);
+        //the frame was handed over when it was read, so the buffer holds no copy that has to be deleted
         if (bufferMessageCounter > 0) {
             requestFrame();
         } else {
@@ -77,13 +84,19 @@ void CanTrafficSinkAppBase::handleMessage(cMessage *msg) {
 }
 
 void CanTrafficSinkAppBase::requestFrame() {
-    CanInputBuffer *buffer = dynamic_cast<CanInputBuffer*> (getParentModule()->getSubmodule("bufferIn"));
-    buffer->deliverNextFrame();
+    //announced frames may have been dropped from a full buffer in the meantime
+    if (inputBuffer->getLength() == 0) {
+        idle = true;
+        return;
+    }
+    inputBuffer->deliverNextFrame();
     idle = false;
 }
 
-void CanTrafficSinkAppBase::startWorkOnFrame(float workTime) {
-    (void)workTime;
+void CanTrafficSinkAppBase::startWorkOnFrame(simtime_t workTime) {
+    if (inputBuffer->isReceiveFifo()) {
+        scheduleAt(simTime() + workTime, new cMessage("workFinished"));
+    }
 }
 
 }
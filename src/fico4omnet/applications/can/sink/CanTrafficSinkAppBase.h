@@ -34,6 +34,8 @@
 
 namespace FiCo4OMNeT {
 
+class CanInputBuffer;
+
 /**
  * @brief Traffic sink application used to handle incomming messages.
  *
@@ -46,8 +48,17 @@ class CanTrafficSinkAppBase: public omnetpp::cSimpleModule {
 protected:
     /**
      * @brief Initialization of the module.
+     *
+     * The input buffer is resolved in the second stage.
+     *
+     * @param stage the initialization stage
      */
-    virtual void initialize();
+    virtual void initialize(int stage);
+
+    /**
+     * @brief Number of initialization stages.
+     */
+    virtual int numInitStages() const { return 2; }
 
     /**
      * @brief Collects incoming message and writes statistics.
@@ -57,7 +68,7 @@ protected:
     virtual void handleMessage(omnetpp::cMessage *msg);
 
     /**
-     * @brief Requests a frame from the buffer.
+     * @brief Requests a frame from the buffer. The application becomes idle if the buffer is empty.
      */
     void requestFrame();
 
@@ -76,13 +87,25 @@ protected:
      */
     unsigned int currentFrameID;
 
+    /**
+     * @brief The input buffer of the node.
+     */
+    CanInputBuffer *inputBuffer;
+
+    /**
+     * @brief Time it takes to read a frame from a receive FIFO.
+     */
+    omnetpp::simtime_t workTime;
+
 private:
     /**
      * @brief The sink processes the frame.
      *
+     * Only frames read from a receive FIFO take time, until then the frame occupies the application.
+     *
      * @param workTime represents the time it takes to process the current frame.
      */
-    void startWorkOnFrame(float workTime);
+    void startWorkOnFrame(omnetpp::simtime_t workTime);
 
     /**
      * @brief Simsignal for received data frames.
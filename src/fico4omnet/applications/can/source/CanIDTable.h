@@ -0,0 +1,136 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANIDTABLE_H_
+#define FICO4OMNET_CANIDTABLE_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+//Std
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace FiCo4OMNeT {
+
+/**
+ * @brief Table that maps can IDs to values.
+ *
+ * For 2.0A (11 bit) the table is a flat array indexed by the can ID. For 2.0B (29 bit) only the registered IDs
+ * are stored in a hash map. Lookups of unregistered IDs return a value-initialized T, e.g. nullptr for pointers.
+ *
+ * @ingroup Applications
+ */
+template<typename T>
+class CanIDTable {
+
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param idBits width of the can identifier in bits (11 for 2.0A, 29 for 2.0B)
+     */
+    explicit CanIDTable(unsigned int idBits = 11) {
+        reset(idBits);
+    }
+
+    /**
+     * @brief Removes all entries and sets the width of the identifier space.
+     *
+     * @param idBits width of the can identifier in bits (11 for 2.0A, 29 for 2.0B)
+     */
+    void reset(unsigned int idBits) {
+        isDense = idBits <= MAXDENSEBITS;
+        dense.assign(isDense ? (static_cast<size_t>(1) << idBits) : 0, T());
+        sparse.clear();
+    }
+
+    /**
+     * @brief Adds an entry for the can ID. An existing entry for the can ID is kept.
+     *
+     * @param canID the can ID
+     * @param value the value for the can ID
+     *
+     * @return true if the entry was added, false if the can ID already had an entry
+     *
+     * @throws cRuntimeError if the can ID exceeds the identifier space
+     */
+    bool insert(unsigned int canID, T value) {
+        if (isDense) {
+            if (canID >= dense.size()) {
+                throw omnetpp::cRuntimeError("The can ID %u exceeds the identifier space of the table.", canID);
+            }
+            if (dense[canID] != T()) {
+                return false;
+            }
+            dense[canID] = value;
+            return true;
+        }
+        return sparse.insert(std::make_pair(canID, value)).second;
+    }
+
+    /**
+     * @brief Returns the value for the can ID.
+     *
+     * @param canID the can ID
+     *
+     * @return the value for the can ID, a value-initialized T if the can ID has no entry
+     */
+    T find(unsigned int canID) const {
+        if (isDense) {
+            return canID < dense.size() ? dense[canID] : T();
+        }
+        typename std::unordered_map<unsigned int, T>::const_iterator it = sparse.find(canID);
+        return it != sparse.end() ? it->second : T();
+    }
+
+private:
+    /**
+     * @brief Identifier spaces with at most this width are stored as flat array.
+     */
+    static const unsigned int MAXDENSEBITS = 11;
+
+    /**
+     * @brief true if #dense is used, false if #sparse is used
+     */
+    bool isDense;
+
+    /**
+     * @brief Values of a flat table indexed by the can ID.
+     */
+    std::vector<T> dense;
+
+    /**
+     * @brief Values of the registered can IDs of a sparse table.
+     */
+    std::unordered_map<unsigned int, T> sparse;
+};
+
+}
+
+#endif
@@ -0,0 +1,288 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/applications/can/source/CanTrafficPatternSourceApp.h"
+
+namespace FiCo4OMNeT {
+
+Define_Module(CanTrafficPatternSourceApp);
+
+CanTrafficPatternSourceApp::CanTrafficPatternSourceApp() {
+    this->pattern = Pattern::POISSON;
+    this->eventRate = 0;
+    this->minInterArrivalTime = 0;
+    this->eventPeriod = 0;
+    this->meanOnTime = 0;
+    this->meanOffTime = 0;
+    this->arrivalRng = nullptr;
+    this->burstRng = nullptr;
+    this->patternTimer = nullptr;
+}
+
+CanTrafficPatternSourceApp::~CanTrafficPatternSourceApp() {
+    actions.clear();
+    cancelAndDelete(patternTimer);
+    eventFramesByPrototype.clear();
+    eventFrames.clear();
+}
+
+void CanTrafficPatternSourceApp::initialize(int stage) {
+    CanTrafficSourceAppBase::initialize(stage);
+    if (stage == 0) {
+        readPatternParameters();
+        patternTimer = new cMessage("patternTimer");
+    } else if (stage == 2) {
+        initialEventFrameCreation();
+    }
+}
+
+void CanTrafficPatternSourceApp::readPatternParameters() {
+    const char *patternName = par("trafficPattern").stringValue();
+    if (strcmp(patternName, "poisson") == 0) {
+        pattern = Pattern::POISSON;
+    } else if (strcmp(patternName, "sporadic") == 0) {
+        pattern = Pattern::SPORADIC;
+    } else if (strcmp(patternName, "burst") == 0) {
+        pattern = Pattern::BURST;
+    } else if (strcmp(patternName, "periodicOnChange") == 0) {
+        pattern = Pattern::PERIODIC_ON_CHANGE;
+    } else {
+        throw cRuntimeError("Unknown traffic pattern \"%s\". Use poisson, sporadic, burst or periodicOnChange.",
+                patternName);
+    }
+    eventRate = par("eventRate").doubleValue();
+    minInterArrivalTime = par("minInterArrivalTime").doubleValue();
+    eventPeriod = par("eventPeriod").doubleValue();
+    meanOnTime = par("meanOnTime").doubleValue();
+    meanOffTime = par("meanOffTime").doubleValue();
+
+    if ((pattern == Pattern::POISSON || pattern == Pattern::SPORADIC) ? eventRate <= 0 : eventRate < 0) {
+        throw cRuntimeError("The value for the parameter \"eventRate\" is not permitted for the traffic pattern %s.",
+                patternName);
+    }
+    if ((pattern == Pattern::BURST || pattern == Pattern::PERIODIC_ON_CHANGE) && eventPeriod <= 0) {
+        throw cRuntimeError("The value for the parameter \"eventPeriod\" is not permitted. Permitted values are greater than 0.");
+    }
+    if (pattern == Pattern::BURST && (meanOnTime <= 0 || meanOffTime <= 0)) {
+        throw cRuntimeError("The values for the parameters \"meanOnTime\" and \"meanOffTime\" are not permitted. Permitted values are greater than 0.");
+    }
+    if (minInterArrivalTime < SIMTIME_ZERO) {
+        throw cRuntimeError("The value for the parameter \"minInterArrivalTime\" is not permitted. Permitted values are 0 or greater.");
+    }
+
+    //only the RNGs the pattern draws from have to be configured
+    if (pattern != Pattern::BURST && eventRate > 0) {
+        arrivalRng = getRNG(par("arrivalRng").intValue());
+    }
+    if (pattern == Pattern::BURST) {
+        burstRng = getRNG(par("burstRng").intValue());
+    }
+}
+
+void CanTrafficPatternSourceApp::initialEventFrameCreation() {
+    if (par("idEventFrames").stdstringValue().empty()) {
+        return;
+    }
+    std::vector<int> frameIDs = cStringTokenizer(par("idEventFrames"), ",").asIntVector();
+    cStringTokenizer dataLengthTokenizer(par("dataLengthEventFrames"), ",");
+    cStringTokenizer payloadTokenizer(par("payloadEventFrames"), ",");
+    simtime_t start = simTime() + par("initialEventOffset").doubleValue();
+
+    double period = 0;
+    switch (pattern) {
+    case Pattern::POISSON:
+        period = 1 / eventRate;
+        break;
+    case Pattern::SPORADIC:
+        period = minInterArrivalTime.dbl();
+        break;
+    case Pattern::BURST:
+    case Pattern::PERIODIC_ON_CHANGE:
+        period = eventPeriod;
+        break;
+    }
+
+    //the lookup points to the elements, so the vector must not grow afterwards
+    eventFrames.resize(frameIDs.size());
+    for (unsigned int i = 0; i < frameIDs.size(); i++) {
+        if (!dataLengthTokenizer.hasMoreTokens()) {
+            throw cRuntimeError("No more values for the event frame data length for the next event frame ID (at index %d). Configuration in the ini file may be incorrect.", i);
+        }
+        unsigned int dataFieldLength = static_cast<unsigned int> (atoi(dataLengthTokenizer.nextToken()));
+        const char *payload = payloadTokenizer.hasMoreTokens() ? payloadTokenizer.nextToken() : nullptr;
+
+        EventFrame *frame = &eventFrames[i];
+        frame->prototype = createPrototype("eventMessage", static_cast<unsigned int> (frameIDs.at(i)), false,
+                dataFieldLength, period, payload);
+        addDataFramePrototype(frame->prototype);
+        eventFramesByPrototype[frame->prototype] = frame;
+        frame->action = Action::NONE;
+        frame->phaseEnd = SIMTIME_ZERO;
+        frame->lastTransmission = SIMTIME_ZERO;
+        frame->transmitted = false;
+
+        switch (pattern) {
+        case Pattern::POISSON:
+        case Pattern::SPORADIC:
+            scheduleAction(frame, Action::EVENT, start + omnetpp::exponential(arrivalRng, 1 / eventRate));
+            break;
+        case Pattern::BURST:
+            //every frame starts in an off phase
+            scheduleAction(frame, Action::PHASE_START, start + omnetpp::exponential(burstRng, meanOffTime));
+            break;
+        case Pattern::PERIODIC_ON_CHANGE:
+            //the period of the prototype is the event period
+            schedulePeriodicFrame(frame->prototype, start);
+            if (eventRate > 0) {
+                scheduleAction(frame, Action::EVENT, start + omnetpp::exponential(arrivalRng, 1 / eventRate));
+            }
+            break;
+        }
+    }
+    if (dataLengthTokenizer.hasMoreTokens()) {
+        EV<< "There are more values defined for the event frame data length. Please check your configuration files.";
+    }
+}
+
+void CanTrafficPatternSourceApp::handleMessage(cMessage *msg) {
+    if (msg != patternTimer) {
+        CanTrafficSourceAppBase::handleMessage(msg);
+        return;
+    }
+    while (actions.isDue(simTime())) {
+        handleAction(eventFramesByPrototype.at(actions.pop()));
+    }
+    updatePatternTimer();
+}
+
+void CanTrafficPatternSourceApp::frameTransmission(CanDataFrame *df, bool periodic) {
+    CanTrafficSourceAppBase::frameTransmission(df, periodic);
+    if (!periodic) {
+        return;
+    }
+    std::unordered_map<const CanDataFrame*, EventFrame*>::iterator it = eventFramesByPrototype.find(df);
+    if (it == eventFramesByPrototype.end()) {
+        return;
+    }
+    EventFrame *frame = it->second;
+    markTransmitted(frame);
+    if (frame->action == Action::DEFERRED) {
+        //the periodic transmission covers the postponed transmission
+        actions.remove(frame->prototype);
+        frame->action = Action::NONE;
+        scheduleNextEvent(frame);
+        updatePatternTimer();
+    }
+}
+
+void CanTrafficPatternSourceApp::scheduleAction(EventFrame *frame, Action action, simtime_t time) {
+    frame->action = action;
+    actions.insert(frame->prototype, time);
+    if (!patternTimer->isScheduled() || time < patternTimer->getArrivalTime()) {
+        updatePatternTimer();
+    }
+}
+
+void CanTrafficPatternSourceApp::updatePatternTimer() {
+    if (actions.empty()) {
+        cancelEvent(patternTimer);
+    } else if (!patternTimer->isScheduled() || patternTimer->getArrivalTime() != actions.nextTime()) {
+        cancelEvent(patternTimer);
+        scheduleAt(actions.nextTime(), patternTimer);
+    }
+}
+
+void CanTrafficPatternSourceApp::scheduleNextEvent(EventFrame *frame) {
+    scheduleAction(frame, Action::EVENT, simTime() + omnetpp::exponential(arrivalRng, 1 / eventRate));
+}
+
+void CanTrafficPatternSourceApp::scheduleNextOnFrame(EventFrame *frame) {
+    simtime_t next = simTime() + eventPeriod;
+    if (next < frame->phaseEnd) {
+        scheduleAction(frame, Action::ON_FRAME, next);
+    } else {
+        scheduleAction(frame, Action::PHASE_END, frame->phaseEnd);
+    }
+}
+
+void CanTrafficPatternSourceApp::handleAction(EventFrame *frame) {
+    Action action = frame->action;
+    frame->action = Action::NONE;
+    switch (action) {
+    case Action::EVENT:
+        if (pattern == Pattern::POISSON) {
+            scheduleNextEvent(frame);
+            transmit(frame);
+        } else {
+            requestTransmission(frame);
+        }
+        break;
+    case Action::DEFERRED:
+        //the Poisson process is memoryless, so the events combined into this transmission need not be drawn
+        transmit(frame);
+        scheduleNextEvent(frame);
+        break;
+    case Action::PHASE_START:
+        frame->phaseEnd = simTime() + omnetpp::exponential(burstRng, meanOnTime);
+        transmit(frame);
+        scheduleNextOnFrame(frame);
+        break;
+    case Action::ON_FRAME:
+        transmit(frame);
+        scheduleNextOnFrame(frame);
+        break;
+    case Action::PHASE_END:
+        scheduleAction(frame, Action::PHASE_START, simTime() + omnetpp::exponential(burstRng, meanOffTime));
+        break;
+    default:
+        throw cRuntimeError("The event frame with ID %u has no pending action.", frame->prototype->getCanID());
+    }
+}
+
+void CanTrafficPatternSourceApp::requestTransmission(EventFrame *frame) {
+    if (!frame->transmitted || simTime() - frame->lastTransmission >= minInterArrivalTime) {
+        transmit(frame);
+        scheduleNextEvent(frame);
+    } else {
+        //events until the end of the minimum inter-arrival time are combined into this transmission
+        scheduleAction(frame, Action::DEFERRED, frame->lastTransmission + minInterArrivalTime);
+    }
+}
+
+void CanTrafficPatternSourceApp::transmit(EventFrame *frame) {
+    emit(sentDFSignal, frame->prototype);
+    forwardFrame(createOutgoingFrame(frame->prototype));
+    markTransmitted(frame);
+}
+
+void CanTrafficPatternSourceApp::markTransmitted(EventFrame *frame) {
+    frame->lastTransmission = simTime();
+    frame->transmitted = true;
+}
+
+}
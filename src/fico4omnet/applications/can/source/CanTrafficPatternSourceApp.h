@@ -0,0 +1,250 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANTRAFFICPATTERNSOURCEAPP_H_
+#define FICO4OMNET_CANTRAFFICPATTERNSOURCEAPP_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+#include "fico4omnet/applications/can/source/CanTrafficSourceAppBase.h"
+#include "fico4omnet/scheduler/can/CanFrameCalendar.h"
+//Std
+#include <unordered_map>
+#include <vector>
+//Auto-generated messages
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
+
+namespace FiCo4OMNeT {
+
+/**
+ * @brief Traffic source application that generates event-triggered data frames in addition to the periodic frames.
+ *
+ * All event frames of the application follow the same traffic pattern:
+ * - poisson: the frames are sent at the events of a Poisson process.
+ * - sporadic: events of a Poisson process are sent, but not faster than the minimum inter-arrival time. Events that
+ *   occur earlier are combined into one transmission at the end of the minimum inter-arrival time.
+ * - burst: on and off phases with exponentially distributed durations alternate. During an on phase the frames are
+ *   sent with the event period.
+ * - periodicOnChange: the frames are sent with the event period and additionally on every event of a Poisson process,
+ *   limited by the minimum inter-arrival time (periodic and on event transmission mode of AUTOSAR). The periodic
+ *   transmissions are scheduled like the periodic data frames of the base class.
+ *
+ * Every event frame has at most one pending action. The actions of all event frames are kept in a calendar that is
+ * served by a single self message. The events are drawn from the RNG #arrivalRng, the durations of the on and off
+ * phases from the RNG #burstRng.
+ *
+ * @ingroup Applications
+ */
+class CanTrafficPatternSourceApp : public virtual CanTrafficSourceAppBase {
+
+public:
+    /**
+     * @brief Constructor
+     */
+    CanTrafficPatternSourceApp();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~CanTrafficPatternSourceApp();
+
+protected:
+    /**
+     * @brief Initialization of the module.
+     *
+     * The event frames are created in the last stage, after the periodic frames.
+     *
+     * @param stage the initialization stage
+     */
+    virtual void initialize(int stage);
+
+    /**
+     * @brief Handles the #patternTimer, all other messages are handled by the base class.
+     *
+     * @param msg incoming message
+     */
+    virtual void handleMessage(omnetpp::cMessage *msg);
+
+    /**
+     * @brief Transmits a frame like the base class and records periodic transmissions of the event frames.
+     *
+     * A periodic transmission of an event frame also covers a postponed transmission of the frame.
+     *
+     * @param df the frame that should be sent
+     * @param periodic true if df is the prototype of a periodic frame, false if df is a received remote frame
+     */
+    virtual void frameTransmission(CanDataFrame *df, bool periodic);
+
+private:
+    /**
+     * @brief Traffic patterns of the event frames.
+     */
+    enum class Pattern {
+        POISSON, SPORADIC, BURST, PERIODIC_ON_CHANGE
+    };
+
+    /**
+     * @brief Pending actions of an event frame.
+     */
+    enum class Action {
+        NONE, //!< no action is pending
+        EVENT, //!< next event of the Poisson process
+        DEFERRED, //!< transmission postponed by the minimum inter-arrival time
+        PHASE_START, //!< start of an on phase
+        ON_FRAME, //!< next frame of an on phase
+        PHASE_END //!< end of an on phase
+    };
+
+    /**
+     * @brief State of an event frame.
+     */
+    struct EventFrame {
+        CanDataFrame *prototype;
+        Action action;
+        omnetpp::simtime_t phaseEnd;
+        omnetpp::simtime_t lastTransmission;
+        bool transmitted;
+    };
+
+    /**
+     * @brief Traffic pattern of all event frames.
+     */
+    Pattern pattern;
+
+    /**
+     * @brief Mean number of events per second.
+     */
+    double eventRate;
+
+    /**
+     * @brief Minimum time between two transmissions of an event frame.
+     */
+    omnetpp::simtime_t minInterArrivalTime;
+
+    /**
+     * @brief Period of the frames during an on phase or of the periodic transmissions.
+     */
+    double eventPeriod;
+
+    /**
+     * @brief Mean duration of an on phase.
+     */
+    double meanOnTime;
+
+    /**
+     * @brief Mean duration of an off phase.
+     */
+    double meanOffTime;
+
+    /**
+     * @brief RNG for the events, nullptr if the pattern has no events.
+     */
+    omnetpp::cRNG *arrivalRng;
+
+    /**
+     * @brief RNG for the durations of the on and off phases, nullptr if the pattern has no phases.
+     */
+    omnetpp::cRNG *burstRng;
+
+    /**
+     * @brief State of the event frames.
+     */
+    std::vector<EventFrame> eventFrames;
+
+    /**
+     * @brief Event frames by their prototype.
+     */
+    std::unordered_map<const CanDataFrame*, EventFrame*> eventFramesByPrototype;
+
+    /**
+     * @brief Times of the pending actions of the event frames, keyed by their prototype.
+     */
+    CanFrameCalendar actions;
+
+    /**
+     * @brief Self message for the earliest action in #actions.
+     */
+    omnetpp::cMessage *patternTimer;
+
+    /**
+     * @brief Reads the pattern parameters and checks their values.
+     */
+    void readPatternParameters();
+
+    /**
+     * @brief Creates the event frames and schedules their first actions.
+     */
+    void initialEventFrameCreation();
+
+    /**
+     * @brief Sets the pending action of the event frame.
+     *
+     * @param frame the event frame without pending action
+     * @param action the action
+     * @param time the time of the action
+     */
+    void scheduleAction(EventFrame *frame, Action action, omnetpp::simtime_t time);
+
+    /**
+     * @brief Schedules the #patternTimer for the earliest action in #actions.
+     */
+    void updatePatternTimer();
+
+    /**
+     * @brief Schedules the next event of the Poisson process of the frame.
+     */
+    void scheduleNextEvent(EventFrame *frame);
+
+    /**
+     * @brief Schedules the next frame or the end of the current on phase.
+     */
+    void scheduleNextOnFrame(EventFrame *frame);
+
+    /**
+     * @brief Performs the pending action of the event frame.
+     */
+    void handleAction(EventFrame *frame);
+
+    /**
+     * @brief Sends the frame now or postpones it to the end of the minimum inter-arrival time.
+     */
+    void requestTransmission(EventFrame *frame);
+
+    /**
+     * @brief Sends an outgoing frame created from the prototype of the event frame.
+     */
+    void transmit(EventFrame *frame);
+
+    /**
+     * @brief Records a transmission of the event frame at the current time.
+     */
+    void markTransmitted(EventFrame *frame);
+};
+
+}
+#endif /* FICO4OMNET_CANTRAFFICPATTERNSOURCEAPP_H_ */
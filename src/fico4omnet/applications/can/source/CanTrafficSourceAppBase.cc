@@ -28,8 +28,14 @@
 
 #include "fico4omnet/applications/can/source/CanTrafficSourceAppBase.h"
 
+#include "fico4omnet/buffer/can/CanOutputBuffer.h"
 #include "fico4omnet/scheduler/can/CanClock.h"
+#include "fico4omnet/scheduler/can/CanTrafficDriver.h"
 #include "fico4omnet/linklayer/can/CanPortInput.h"
+#include "fico4omnet/utilities/HelperFunctions.h"
+
+//Std
+#include <algorithm>
 
 namespace FiCo4OMNeT {
 
@@ -38,7 +44,16 @@ Define_Module(CanTrafficSourceAppBase);
 CanTrafficSourceAppBase::CanTrafficSourceAppBase()
 {
     this->bitStuffingPercentage = 0;
+    this->exactBitStuffing = false;
+    this->canVersion = CanVersion::V2_0A;
+    std::fill(frameLengths, frameLengths + CanFrameLength::MAXDATALENGTH + 1, 0);
     this->currentDrift = 0;
+    this->periodInaccurracy = 0;
+    this->canClock = nullptr;
+    this->singleTransmissionTimer = false;
+    this->transmissionTimer = nullptr;
+    this->trafficDriver = nullptr;
+    this->outputBuffer = nullptr;
 }
 
 CanTrafficSourceAppBase::~CanTrafficSourceAppBase()
@@ -48,23 +63,46 @@ CanTrafficSourceAppBase::~CanTrafficSourceAppBase()
         cancelAndDelete((*it));
     }
     outgoingDataFrames.clear();
+    for (std::list<CanDataFrame*>::iterator it = outgoingRemoteFrames.begin(); it != outgoingRemoteFrames.end(); ++it)
+    {
+        cancelAndDelete((*it));
+    }
+    outgoingRemoteFrames.clear();
+    calendar.clear();
+    cancelAndDelete(transmissionTimer);
 }
 
 void CanTrafficSourceAppBase::initialize(int stage) {
     if (stage == 0) {
-        canVersion =
+        canVersion = CanFrameLength::parseVersion(
                 getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule()->par(
-                        "version").stdstringValue();
+                        "version").stdstringValue());
+        remoteResponders.reset(CanFrameLength::idBits(canVersion));
         bitStuffingPercentage =
                 getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule()->par(
                         "bitStuffingPercentage");
+        exactBitStuffing =
+                getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule()->par(
+                        "exactBitStuffing").boolValue();
         sentDFSignal = registerSignal("txDF");
         sentRFSignal = registerSignal("txRF");
+        singleTransmissionTimer = par("singleTransmissionTimer").boolValue();
+        transmissionTimer = new cMessage("transmissionTimer");
+        CanTrafficSourceAppBase::handleParameterChange(nullptr);
         checkParameterValues();
+        for (unsigned int dataLength = 0; dataLength <= CanFrameLength::MAXDATALENGTH; dataLength++) {
+            frameLengths[dataLength] = CanFrameLength::lookup(canVersion, dataLength, CanStuffing::NONE)
+                    + calculateStuffingBits(dataLength);
+        }
     } else if (stage == 2) {
-        CanClock* canClock =
-                dynamic_cast<CanClock*>(getParentModule()->getSubmodule("canClock"));
+        canClock = resolveModule<CanClock>(getParentModule()->getSubmodule("canClock"), "canClock", this);
         currentDrift = canClock->getCurrentDrift();
+        cModule *bus = getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule();
+        trafficDriver = dynamic_cast<CanTrafficDriver*>(bus->getSubmodule("trafficDriver"));
+        if (trafficDriver != nullptr) {
+            outputBuffer = resolveModule<CanOutputBuffer>(gate("out")->getPathEndGate()->getOwnerModule(),
+                    "output buffer connected to gate out", this);
+        }
         initialDataFrameCreation();
         initialRemoteFrameCreation();
     }
@@ -75,15 +113,76 @@ void CanTrafficSourceAppBase::checkParameterValues() {
         throw cRuntimeError(
                 "The value for the parameter \"bitStuffingPercentage\" is not permitted. Permitted values are from 0 to 1.");
     }
-    if (canVersion.compare("2.0A") != 0 && canVersion.compare("2.0B") != 0) {
-        throw cRuntimeError(
-                "The value for the parameter \"canVersion\" is not permitted. Permitted values are \"2.0B\" and \"2.0A\".");
+}
+
+void CanTrafficSourceAppBase::handleParameterChange(const char* parname) {
+    if (!parname || !strcmp(parname, "periodInaccurracy")) {
+        periodInaccurracy = par("periodInaccurracy").doubleValue();
     }
 }
 
 void CanTrafficSourceAppBase::handleMessage(cMessage *msg) {
+    if (msg == transmissionTimer) {
+        //collect first, frames rescheduled for the current time are sent with the next timer event
+        while (calendar.isDue(simTime())) {
+            dueFrames.push_back(calendar.pop());
+        }
+        for (std::vector<CanDataFrame*>::iterator it = dueFrames.begin(); it != dueFrames.end(); ++it) {
+            frameTransmission(*it, true);
+        }
+        dueFrames.clear();
+        updateTransmissionTimer();
+        return;
+    }
     CanDataFrame *df = check_and_cast<CanDataFrame *>(msg);
-    frameTransmission(df);
+    frameTransmission(df, msg->isSelfMessage());
+}
+
+void CanTrafficSourceAppBase::scheduleNextTransmission(CanDataFrame *df) {
+    currentDrift = canClock->getCurrentDrift();
+    simtime_t time = simTime() + (df->getPeriod()) + SimTime(periodInaccurracy + currentDrift);
+    if (time < simTime()) {
+        throw cRuntimeError("The next transmission of the frame with ID %u would be in the past.", df->getCanID());
+    }
+    schedulePeriodicFrame(df, time);
+}
+
+void CanTrafficSourceAppBase::releasePeriodicFrame(CanDataFrame *df) {
+    Enter_Method_Silent
+    ();
+    frameTransmission(df, true);
+}
+
+void CanTrafficSourceAppBase::schedulePeriodicFrame(CanDataFrame *df, simtime_t time) {
+    if (trafficDriver != nullptr) {
+        trafficDriver->schedulePeriodicFrame(this, df, time);
+        return;
+    }
+    if (!singleTransmissionTimer) {
+        scheduleAt(time, df);
+        return;
+    }
+    calendar.insert(df, time);
+    if (!transmissionTimer->isScheduled() || time < transmissionTimer->getArrivalTime()) {
+        updateTransmissionTimer();
+    }
+}
+
+void CanTrafficSourceAppBase::forwardFrame(CanDataFrame *frame) {
+    if (outputBuffer != nullptr) {
+        outputBuffer->putFrameDirect(frame);
+    } else {
+        send(frame, "out");
+    }
+}
+
+void CanTrafficSourceAppBase::updateTransmissionTimer() {
+    if (calendar.empty()) {
+        cancelEvent(transmissionTimer);
+    } else if (!transmissionTimer->isScheduled() || transmissionTimer->getArrivalTime() != calendar.nextTime()) {
+        cancelEvent(transmissionTimer);
+        scheduleAt(calendar.nextTime(), transmissionTimer);
+    }
 }
 
 void CanTrafficSourceAppBase::initialRemoteFrameCreation() {
@@ -93,8 +192,10 @@ void CanTrafficSourceAppBase::initialRemoteFrameCreation() {
         cStringTokenizer dataLengthRemoteFramesTokenizer(par("dataLengthRemoteFrames"), ",");
         cStringTokenizer initialRemoteFrameOffsetTokenizer(par("initialRemoteFrameOffset"), ",");
 
+        cStringTokenizer payloadRemoteFramesTokenizer("");
+
         initialFrameCreation("remote", remoteFrameIDsTokenizer, remoteFramesPeriodicityTokenizer,
-                dataLengthRemoteFramesTokenizer, initialRemoteFrameOffsetTokenizer);
+                dataLengthRemoteFramesTokenizer, initialRemoteFrameOffsetTokenizer, payloadRemoteFramesTokenizer);
     }
 }
 
@@ -104,15 +205,17 @@ void CanTrafficSourceAppBase::initialDataFrameCreation() {
         cStringTokenizer dataFramesPeriodicityTokenizer(par("periodicityDataFrames"), ",");
         cStringTokenizer dataLengthDataFramesTokenizer(par("dataLengthDataFrames"), ",");
         cStringTokenizer initialDataFrameOffsetTokenizer(par("initialDataFrameOffset"), ",");
+        cStringTokenizer payloadDataFramesTokenizer(par("payloadDataFrames"), ",");
 
         initialFrameCreation("data", dataFrameIDsTokenizer, dataFramesPeriodicityTokenizer,
-                dataLengthDataFramesTokenizer, initialDataFrameOffsetTokenizer);
+                dataLengthDataFramesTokenizer, initialDataFrameOffsetTokenizer, payloadDataFramesTokenizer);
     }
 }
 
 void CanTrafficSourceAppBase::initialFrameCreation(std::string type,
         cStringTokenizer frameIDsTokenizer, cStringTokenizer framesPeriodicityTokenizer,
-        cStringTokenizer dataLengthFramesTokenizer, cStringTokenizer initialFrameOffsetTokenizer) {
+        cStringTokenizer dataLengthFramesTokenizer, cStringTokenizer initialFrameOffsetTokenizer,
+        cStringTokenizer payloadFramesTokenizer) {
 
     const char *frameType = "";
     if (type.compare("data") == 0) {
@@ -132,21 +235,14 @@ void CanTrafficSourceAppBase::initialFrameCreation(std::string type,
         if (!initialFrameOffsetTokenizer.hasMoreTokens()) {
             throw cRuntimeError("No more values for the %s frame offset for the next %s frame ID (at index %d). Configuration in the ini file may be incorrect.", type.c_str(), type.c_str(), i);
         }
-        CanDataFrame *can_msg = new CanDataFrame(frameType);
-        can_msg->setCanID(checkAndReturnID(static_cast<unsigned int> (frameIDs.at(i))));
         unsigned int dataFieldLength = static_cast<unsigned int> (atoi(dataLengthFramesTokenizer.nextToken()));
-        can_msg->setBitLength(calculateLength(dataFieldLength));
-        cPacket *payload_packet = new cPacket;
-        payload_packet->setTimestamp();
-        payload_packet->setByteLength(dataFieldLength);
-        can_msg->encapsulate(payload_packet);
-        can_msg->setPeriod(atof(framesPeriodicityTokenizer.nextToken()));
+        const char *payload = payloadFramesTokenizer.hasMoreTokens() ? payloadFramesTokenizer.nextToken() : nullptr;
+        CanDataFrame *can_msg = createPrototype(frameType, static_cast<unsigned int> (frameIDs.at(i)),
+                type.compare("remote") == 0, dataFieldLength, atof(framesPeriodicityTokenizer.nextToken()), payload);
 
         if (type.compare("data") == 0) {
-            outgoingDataFrames.push_back(can_msg);
-            registerDataFrameAtPort(can_msg->getCanID());
+            addDataFramePrototype(can_msg);
         } else {
-            can_msg->setRtr(true);
             registerRemoteFrameAtPort(can_msg->getCanID());
         }
 
@@ -160,15 +256,18 @@ void CanTrafficSourceAppBase::initialFrameCreation(std::string type,
             }
             delete can_msg;
         } else if (type.compare("remote") == 0 || can_msg->getPeriod() > 0.0) {
+            if (type.compare("remote") == 0) {
+                outgoingRemoteFrames.push_back(can_msg);
+            }
             double offset;
             initialFrameOffsetTokenizer.hasMoreTokens() ?
                     offset = atof(initialFrameOffsetTokenizer.nextToken()) : offset = 0;
             simtime_t scheduleTime = simTime() + SimTime(offset)
-                    + SimTime(par("periodInaccurracy").doubleValue() + currentDrift);
+                    + SimTime(periodInaccurracy + currentDrift);
             if (scheduleTime >= 0 ) {
-                scheduleAt(scheduleTime,can_msg);
+                schedulePeriodicFrame(can_msg, scheduleTime);
             } else {
-                scheduleAt(simTime(),can_msg);
+                schedulePeriodicFrame(can_msg, simTime());
             }
         } else {
             if (initialFrameOffsetTokenizer.hasMoreTokens()) {
@@ -187,6 +286,27 @@ void CanTrafficSourceAppBase::initialFrameCreation(std::string type,
     }
 }
 
+CanDataFrame* CanTrafficSourceAppBase::createPrototype(const char *name, unsigned int canID, bool rtr,
+        unsigned int dataLength, double period, const char *payload) {
+    CanDataFrame *prototype = new CanDataFrame(name);
+    prototype->setCanID(checkAndReturnID(canID));
+    prototype->setRtr(rtr);
+    if (payload != nullptr) {
+        setPayload(prototype, payload);
+    }
+    prototype->setBitLength(calculateLength(prototype, dataLength));
+    prototype->setDataLength(dataLength);
+    prototype->setPeriod(period);
+    initializePrototype(prototype);
+    return prototype;
+}
+
+void CanTrafficSourceAppBase::addDataFramePrototype(CanDataFrame *prototype) {
+    outgoingDataFrames.push_back(prototype);
+    remoteResponders.insert(prototype->getCanID(), prototype);
+    registerDataFrameAtPort(prototype->getCanID());
+}
+
 void CanTrafficSourceAppBase::registerRemoteFrameAtPort(unsigned int canID) {
     CanPortInput* port = dynamic_cast<CanPortInput*> (getParentModule()->getSubmodule(
             "canNodePort")->getSubmodule("canPortInput"));
@@ -200,35 +320,56 @@ void CanTrafficSourceAppBase::registerDataFrameAtPort(unsigned int canID) {
 }
 
 unsigned int CanTrafficSourceAppBase::checkAndReturnID(unsigned int canID) {
-    if (canVersion.compare("2.0A") == 0) {
-        if (canID > VERSIONAMAX) {
-            EV<< "ID " << canID << " not valid." << endl;
-            endSimulation();
-        }
-    } else {
-        if (canID > VERSIONBMAX) {
-            EV << "ID " << canID << " not valid." << endl;
-            endSimulation();
-        }
+    if (canID >> CanFrameLength::idBits(canVersion) != 0) {
+        EV<< "ID " << canID << " not valid." << endl;
+        endSimulation();
     }
     return canID;
 }
 
 unsigned int CanTrafficSourceAppBase::calculateLength(unsigned int dataLength) {
-    unsigned int arbFieldLength = 0;
-    if (canVersion.compare("2.0B") == 0) {
-        arbFieldLength += ARBITRATIONFIELD29BIT;
+    if (dataLength > CanFrameLength::MAXDATALENGTH) {
+        throw cRuntimeError("The data length %u is not permitted. Permitted values are 0 to %u bytes.", dataLength,
+                CanFrameLength::MAXDATALENGTH);
     }
-    return (arbFieldLength + DATAFRAMECONTROLBITS
-            + calculateStuffingBits(dataLength, arbFieldLength));
+    return frameLengths[dataLength];
 }
 
-unsigned int CanTrafficSourceAppBase::calculateStuffingBits(unsigned int dataLength,
-        unsigned int arbFieldLength) {
-    return static_cast<unsigned int>(((CONTROLBITSFORBITSTUFFING + arbFieldLength + (dataLength * 8) - 1)/ 4) * bitStuffingPercentage);
+unsigned int CanTrafficSourceAppBase::calculateLength(const CanDataFrame *frame, unsigned int dataLength) {
+    if (!exactBitStuffing) {
+        return calculateLength(dataLength);
+    }
+    uint8_t data[CanBitStuffing::MAXDATABYTES];
+    for (unsigned int i = 0; i < CanBitStuffing::MAXDATABYTES; i++) {
+        data[i] = frame->getData(i);
+    }
+    return CanFrameLength::lookup(canVersion, 0, CanStuffing::NONE)
+            + CanBitStuffing::countStuffBits(frame->getCanID(), canVersion == CanVersion::V2_0B, frame->getRtr(),
+                    dataLength, data);
+}
+
+void CanTrafficSourceAppBase::setPayload(CanDataFrame *frame, const char *hexBytes) {
+    size_t numDigits = strlen(hexBytes);
+    if (numDigits % 2 != 0 || numDigits / 2 > frame->getDataArraySize()) {
+        throw cRuntimeError("The payload \"%s\" is not permitted. Permitted are up to %u bytes as pairs of hexadecimal digits.",
+                hexBytes, static_cast<unsigned int>(frame->getDataArraySize()));
+    }
+    for (size_t i = 0; i < numDigits / 2; i++) {
+        char digits[3] = { hexBytes[2 * i], hexBytes[2 * i + 1], '\0' };
+        char *end = nullptr;
+        unsigned long value = strtoul(digits, &end, 16);
+        if (end != digits + 2) {
+            throw cRuntimeError("The payload \"%s\" is not permitted. Permitted are hexadecimal digits only.", hexBytes);
+        }
+        frame->setData(static_cast<unsigned int>(i), static_cast<uint8_t>(value));
+    }
 }
 
-void CanTrafficSourceAppBase::frameTransmission(CanDataFrame *df) {
+unsigned int CanTrafficSourceAppBase::calculateStuffingBits(unsigned int dataLength) {
+    return static_cast<unsigned int>(CanFrameLength::worstCaseStuffBits(canVersion, dataLength) * bitStuffingPercentage);
+}
+
+void CanTrafficSourceAppBase::frameTransmission(CanDataFrame *df, bool periodic) {
     CanDataFrame *outgoingFrame = nullptr;
 
     if (df->getRtr()) {
@@ -237,34 +378,31 @@ void CanTrafficSourceAppBase::frameTransmission(CanDataFrame *df) {
         emit(sentDFSignal, df);
     }
 
-    if (df->isSelfMessage()) {
-        outgoingFrame = df->dup();
-        CanClock* canClock =
-                dynamic_cast<CanClock*>(getParentModule()->getSubmodule("canClock"));
-        currentDrift = canClock->getCurrentDrift();
-        scheduleAt(
-                simTime() + (df->getPeriod())
-                        + SimTime(par("periodInaccurracy").doubleValue() + currentDrift), df);
+    if (periodic) {
+        outgoingFrame = createOutgoingFrame(df);
+        scheduleNextTransmission(df);
     } else if (df->arrivedOn("remoteIn")) {
-        for (std::list<CanDataFrame*>::iterator it =
-                outgoingDataFrames.begin(); it != outgoingDataFrames.end();
-                ++it) {
-            CanDataFrame *tmp = *it;
-            if (tmp->getCanID() == df->getCanID()) {
-                outgoingFrame = tmp->dup();
-                break;
-            }
+        CanDataFrame *responder = remoteResponders.find(df->getCanID());
+        if (responder == nullptr) {
+            throw cRuntimeError("There is no data frame with ID %u to answer the remote frame.", df->getCanID());
         }
+        outgoingFrame = createOutgoingFrame(responder);
         delete df;
     } else {
         throw cRuntimeError("CanTrafficSourceApp received an invalid message.");
     }
 
+    forwardFrame(outgoingFrame);
+}
+
+CanDataFrame* CanTrafficSourceAppBase::createOutgoingFrame(const CanDataFrame *prototype) {
+    CanDataFrame *outgoingFrame = prototype->dup();
     outgoingFrame->setTimestamp(simTime());
-    cPacket* payload_packet = outgoingFrame->decapsulate();
+    cPacket *payload_packet = new cPacket;
     payload_packet->setTimestamp(simTime());
+    payload_packet->setByteLength(prototype->getDataLength());
     outgoingFrame->encapsulate(payload_packet);
-    send(outgoingFrame, "out");
+    return outgoingFrame;
 }
 
 }
@@ -32,11 +32,19 @@
 
 //FiCo4OMNeT
 #include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+#include "fico4omnet/applications/can/source/CanIDTable.h"
+#include "fico4omnet/linklayer/can/CanBitStuffing.h"
+#include "fico4omnet/linklayer/can/CanFrameLength.h"
+#include "fico4omnet/scheduler/can/CanFrameCalendar.h"
 //Auto-generated messages
-#include "fico4omnet/linklayer/can/messages/CanDataFrame_m.h"
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
 
 namespace FiCo4OMNeT {
 
+class CanClock;
+class CanOutputBuffer;
+class CanTrafficDriver;
+
 /**
  * @brief Traffic source application used to generate outgoing data and remote frames.
  *
@@ -57,6 +65,13 @@ public:
      */
     virtual ~CanTrafficSourceAppBase();
 
+    /**
+     * @brief Is called by the ~CanTrafficDriver of the bus when a periodic frame is due.
+     *
+     * @param df the periodic frame
+     */
+    virtual void releasePeriodicFrame(CanDataFrame *df);
+
 protected:
     /**
      * @brief Initialization of the module.
@@ -76,12 +91,21 @@ protected:
      */
     virtual void checkParameterValues();
 
+    /**
+     * @brief Updates the cached parameters.
+     *
+     * @param parname name of the changed parameter, nullptr for all parameters
+     */
+    virtual void handleParameterChange(const char* parname);
+
     /**
      * @brief Incoming messages are processed.
      *
-     * See #frameTransmission(CanDataFrame *df) for further information.
+     * Self messages are periodic frames. With #singleTransmissionTimer all periodic frames that are due are
+     * transmitted on the #transmissionTimer. See #frameTransmission(CanDataFrame *df, bool periodic) for further
+     * information.
      *
-     * @param msg incoming self message
+     * @param msg incoming self message or remote frame
      */
     virtual void handleMessage(omnetpp::cMessage *msg);
 
@@ -96,12 +120,99 @@ protected:
      */
     unsigned int calculateLength(unsigned int dataLength);
 
+    /**
+     * @brief Calculates the length for the frame.
+     *
+     * If the bus uses exact bit stuffing, the stuff bits are calculated from the can ID, the remote flag and the
+     * payload bytes of the frame. Otherwise #calculateLength(unsigned int) is used.
+     *
+     * @param frame the frame with can ID, remote flag and payload bytes set
+     * @param dataLength Size of the data field in bytes
+     *
+     * @return Returns the size for the can frame without the size needed for the data field.
+     */
+    unsigned int calculateLength(const CanDataFrame *frame, unsigned int dataLength);
+
     /**
      * @brief Transmits a data or remote frame to the connected output buffer.
      *
      * @param df the frame that should be sent
+     * @param periodic true if df is the prototype of a periodic frame, false if df is a received remote frame
+     */
+    virtual void frameTransmission(CanDataFrame *df, bool periodic);
+
+    /**
+     * @brief Is called once for every frame prototype after its creation.
+     *
+     * Subclasses can adjust the prototype here instead of every outgoing frame.
+     *
+     * @param prototype the data or remote frame prototype
      */
-    virtual void frameTransmission(CanDataFrame *df);
+    virtual void initializePrototype(CanDataFrame *prototype) {}
+
+    /**
+     * @brief Creates an outgoing frame from a prototype.
+     *
+     * The prototypes carry no payload packet. The payload packet of the outgoing frame is created with the length
+     * of the data field and the current time as timestamp.
+     *
+     * @param prototype the data or remote frame prototype
+     *
+     * @return the outgoing frame
+     */
+    CanDataFrame* createOutgoingFrame(const CanDataFrame *prototype);
+
+    /**
+     * @brief Creates a frame prototype.
+     *
+     * The can ID is checked, the frame length is calculated and #initializePrototype(CanDataFrame*) is called.
+     *
+     * @param name name of the frame
+     * @param canID the can ID
+     * @param rtr true for a remote frame
+     * @param dataLength Size of the data field in bytes
+     * @param period transmission period of the frame
+     * @param payload the payload bytes as hexadecimal digits, nullptr if the payload is not configured
+     *
+     * @return the prototype, the caller has to take the ownership
+     */
+    CanDataFrame* createPrototype(const char *name, unsigned int canID, bool rtr, unsigned int dataLength,
+            double period, const char *payload);
+
+    /**
+     * @brief Takes the ownership of a data frame prototype.
+     *
+     * The frame is registered at the port and answers incoming remote frames with its can ID.
+     *
+     * @param prototype the data frame prototype
+     */
+    void addDataFramePrototype(CanDataFrame *prototype);
+
+    /**
+     * @brief Schedules the next transmission of a periodic frame.
+     *
+     * The period of the frame, the period inaccuracy and the current drift of the can clock are applied.
+     *
+     * @param df the periodic frame
+     */
+    void scheduleNextTransmission(CanDataFrame *df);
+
+    /**
+     * @brief Schedules a transmission of a periodic frame at the given time.
+     *
+     * @param df the periodic frame
+     * @param time the transmission time
+     */
+    void schedulePeriodicFrame(CanDataFrame *df, omnetpp::simtime_t time);
+
+    /**
+     * @brief Forwards an outgoing frame to the output buffer.
+     *
+     * The frame is sent on the out gate, or put into the output buffer directly if the traffic of the bus is released by a ~CanTrafficDriver.
+     *
+     * @param frame the outgoing frame
+     */
+    void forwardFrame(CanDataFrame *frame);
 
     /**
      * @brief Simsignal for received data frames.
@@ -118,51 +229,89 @@ protected:
      */
     double currentDrift;
 
+    /**
+     * @brief Inaccuracy added to the schedule time for each frame. Cached value of the parameter periodInaccurracy.
+     */
+    double periodInaccurracy;
+
+    /**
+     * @brief The clock of the node.
+     */
+    CanClock *canClock;
+
     /**
      * @brief Collection including all
      */
     std::list<CanDataFrame*> outgoingDataFrames;
 
+    /**
+     * @brief Data frames of #outgoingDataFrames indexed by can ID, used to answer incoming remote frames.
+     */
+    CanIDTable<CanDataFrame*> remoteResponders;
+
 private:
     /**
-     * @brief Overhead for a data frame.
-     *
-     * The variable includes Start of frame, arbitration field (11 Bit), remote transmission bit,
-     * identifier extension bit, reserved bit, data length code, CRC, CRC-delimiter, ACK-slot,
-     * ACK-delimiter, end of frame and inter frame space.
+     * @brief Periodic remote frames of this node.
+     */
+    std::list<CanDataFrame*> outgoingRemoteFrames;
+
+    /**
+     * @brief Next transmission times of all periodic frames of this node. Only used if #singleTransmissionTimer
+     * is set.
+     */
+    CanFrameCalendar calendar;
+
+    /**
+     * @brief True if the periodic frames share the #transmissionTimer, false if every frame is its own self message.
+     */
+    bool singleTransmissionTimer;
+
+    /**
+     * @brief Single self message for the transmissions of all periodic frames. Only used if
+     * #singleTransmissionTimer is set.
      */
-    static const unsigned int DATAFRAMECONTROLBITS = 47;
+    omnetpp::cMessage *transmissionTimer;
 
     /**
-     * @brief Additional bit needed for the 29 bit ID.
+     * @brief Frames due at the current #transmissionTimer event.
      */
-    static const unsigned int ARBITRATIONFIELD29BIT = 20;
+    std::vector<CanDataFrame*> dueFrames;
 
     /**
-     * @brief Number of control bits which are used in bit-stuffing. Just 34 of the 47 are subject to bit-stuffing.
+     * @brief Traffic driver of the bus, nullptr if the periodic frames are scheduled by the application itself.
      */
-    static const unsigned int CONTROLBITSFORBITSTUFFING = 34;
+    CanTrafficDriver *trafficDriver;
 
     /**
-     * @brief Maximum ID value for Version 2.0A.
+     * @brief Output buffer the frames are put into if the traffic is released by the #trafficDriver.
      */
-    static const unsigned int VERSIONAMAX = 2047;
+    CanOutputBuffer *outputBuffer;
 
     /**
-     * @brief Maximum ID value for Version 2.0B.
+     * @brief Schedules the #transmissionTimer for the earliest frame in the #calendar.
      */
-    static const unsigned int VERSIONBMAX = 536870911;
+    void updateTransmissionTimer();
 
     /**
-     * @brief The version of CAN used in this network. Valid values: 2.0A or 2.0B
+     * @brief The version of CAN used in this network.
      */
-    std::string canVersion;
+    CanVersion canVersion;
+
+    /**
+     * @brief Frame lengths without the data field for the configured version and #bitStuffingPercentage, indexed by the data length.
+     */
+    unsigned int frameLengths[CanFrameLength::MAXDATALENGTH + 1];
 
     /**
      * @brief Value for the percentage distribution for bit stuffing. Valid values: 0 to 1.
      */
     double bitStuffingPercentage;
 
+    /**
+     * @brief True if the stuff bits are calculated exactly from the frame content.
+     */
+    bool exactBitStuffing;
+
     /**
      * @brief Creates a data frame which will be queued in the buffer.
      */
@@ -181,12 +330,22 @@ private:
      * @param framesPeriodicityTokenizer Tokenizer for the transmission-periods of the frames
      * @param dataLengthFramesTokenizer Tokenizer for the datafield-length of the frames
      * @param initialFrameOffsetTokenizer Tokenizer for the first transmission-times of the frames
+     * @param payloadFramesTokenizer Tokenizer for the payload bytes of the frames
      */
     void initialFrameCreation(std::string type,
             omnetpp::cStringTokenizer frameIDsTokenizer,
             omnetpp::cStringTokenizer framesPeriodicityTokenizer,
             omnetpp::cStringTokenizer dataLengthFramesTokenizer,
-            omnetpp::cStringTokenizer initialFrameOffsetTokenizer);
+            omnetpp::cStringTokenizer initialFrameOffsetTokenizer,
+            omnetpp::cStringTokenizer payloadFramesTokenizer);
+
+    /**
+     * @brief Sets the payload bytes of the frame.
+     *
+     * @param frame the frame
+     * @param hexBytes the payload bytes as hexadecimal digits, two digits per byte
+     */
+    void setPayload(CanDataFrame *frame, const char *hexBytes);
 
     /**
      * @brief Registers the outgoing remote frame at the port.
@@ -217,11 +376,10 @@ private:
      * For the calculation the parameter #bitStuffingPercentage is used. A value of 0 means no bit stuffing while a value of 100 stands for the worst case.
      *
      * @param dataLength Size of the data field in bytes
-     * @param arbFieldLength Size of the arbitration field
      *
      * @return Returns the number of stuffing bits.
      */
-    unsigned int calculateStuffingBits(unsigned int dataLength, unsigned int arbFieldLength);
+    unsigned int calculateStuffingBits(unsigned int dataLength);
 };
 }
 #endif /* CANTRAFFICSOURCEAPPBASE_H_ */
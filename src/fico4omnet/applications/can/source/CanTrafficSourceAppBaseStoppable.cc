@@ -26,15 +26,16 @@ void CanTrafficSourceAppBaseStoppable::initialize(int stage) {
     CanTrafficSourceAppBase::initialize(stage);
 }
 
-void CanTrafficSourceAppBaseStoppable::frameTransmission(CanDataFrame *df) {
+void CanTrafficSourceAppBaseStoppable::frameTransmission(CanDataFrame *df, bool periodic) {
     if (!(simTime() >= this->_endTime)) {
-        CanTrafficSourceAppBase::frameTransmission(df);
-    } else if (!df->isSelfMessage()){
+        CanTrafficSourceAppBase::frameTransmission(df, periodic);
+    } else if (!periodic){
         delete df;
     }
 }
 
 void CanTrafficSourceAppBaseStoppable::handleParameterChange(const char* parname) {
+    CanTrafficSourceAppBase::handleParameterChange(parname);
     if (!parname || !strcmp(parname, "endTime")) {
         this->_endTime = par("endTime");
     }
@@ -30,7 +30,7 @@ namespace FiCo4OMNeT {
 class CanTrafficSourceAppBaseStoppable : public virtual CanTrafficSourceAppBase
 {
   protected:
-    virtual void frameTransmission(CanDataFrame *df) override;
+    virtual void frameTransmission(CanDataFrame *df, bool periodic) override;
     virtual void initialize(int stage) override;
     virtual void handleParameterChange(const char* parname) override;
 
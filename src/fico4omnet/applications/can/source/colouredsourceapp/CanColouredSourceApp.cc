@@ -28,8 +28,6 @@
 
 #include "fico4omnet/applications/can/source/colouredsourceapp/CanColouredSourceApp.h"
 
-#include "fico4omnet/scheduler/can/CanClock.h"
-
 namespace FiCo4OMNeT {
 
 Define_Module(CanColouredSourceApp)
@@ -48,49 +46,8 @@ void CanColouredSourceApp::initialize(int stage) {
     CanTrafficSourceAppBase::initialize(stage);
 }
 
-void CanColouredSourceApp::handleMessage(cMessage *msg) {
-    CanDataFrame *df = check_and_cast<CanDataFrame *>(msg);
-    frameTransmission(df);
-}
-
-void CanColouredSourceApp::frameTransmission(CanDataFrame *df) {
-    CanDataFrame *outgoingFrame = nullptr;
-
-    if (df->getRtr()) {
-        emit(sentRFSignal, df);
-    } else {
-        emit(sentDFSignal, df);
-    }
-
-    if (df->isSelfMessage()) {
-        outgoingFrame = df->dup();
-        CanClock* canClock =
-                dynamic_cast<CanClock*>(getParentModule()->getSubmodule("canClock"));
-        currentDrift = canClock->getCurrentDrift();
-        scheduleAt(
-                simTime() + (df->getPeriod())
-                        + SimTime(par("periodInaccurracy").doubleValue() + currentDrift), df);
-    } else if (df->arrivedOn("remoteIn")) {
-        for (std::list<CanDataFrame*>::iterator it =
-                outgoingDataFrames.begin(); it != outgoingDataFrames.end();
-                ++it) {
-            CanDataFrame *tmp = *it;
-            if (tmp->getCanID() == df->getCanID()) {
-                outgoingFrame = tmp->dup();
-                break;
-            }
-        }
-        delete df;
-    } else {
-        throw cRuntimeError("CanColouredSourceApp received an invalid message.");
-    }
-
-    outgoingFrame->setTimestamp(simTime());
-    cPacket* payload_packet = outgoingFrame->decapsulate();
-    payload_packet->setTimestamp(simTime());
-    outgoingFrame->encapsulate(payload_packet);
-    outgoingFrame->setDisplayString(frameDisplayString);
-    send(outgoingFrame, "out");
+void CanColouredSourceApp::initializePrototype(CanDataFrame *prototype) {
+    prototype->setDisplayString(frameDisplayString);
 }
 
 }
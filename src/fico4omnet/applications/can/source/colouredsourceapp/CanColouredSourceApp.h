@@ -34,7 +34,7 @@
 #include "fico4omnet/base/FiCo4OMNeT_Defs.h"
 #include "fico4omnet/applications/can/source/CanTrafficSourceAppBase.h"
 //Auto-generated messages
-#include "fico4omnet/linklayer/can/messages/CanDataFrame_m.h"
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
 
 namespace FiCo4OMNeT {
 
@@ -68,26 +68,17 @@ protected:
     virtual void initialize(int stage);
 
     /**
-     * @brief Incoming messages are processed.
+     * @brief Sets the configured display string on the frame prototype.
      *
-     * See #frameTransmission(CanDataFrame *df) for further information.
-     *
-     * @param msg incoming self message
+     * @param prototype the data or remote frame prototype
      */
-    virtual void handleMessage(omnetpp::cMessage *msg);
+    virtual void initializePrototype(CanDataFrame *prototype);
 
 private:
     /**
      * @brief Holds the display string configured in the ini file.
      */
     const char* frameDisplayString;
-
-    /**
-     * @brief Transmits a data or remote frame to the connected output buffer.
-     *
-     * @param df the frame that should be sent
-     */
-    void frameTransmission(CanDataFrame *df);
 };
 }
 #endif /* CANCOLOUREDSOURCEAPPE_H_ */
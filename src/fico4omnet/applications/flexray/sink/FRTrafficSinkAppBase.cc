@@ -46,9 +46,7 @@ void FRTrafficSinkAppBase::handleMessage(cMessage *msg) {
         bufferMessageCounter--;
         startWorkOnFrame(0); //TODO working time
     } else if (msg->isSelfMessage()) {
-        FRInputBuffer *buffer =
-                dynamic_cast<FRInputBuffer*> (getParentModule()->getSubmodule("inputBuffer"));
-        buffer->deleteFrame(currentFrameID);
+        //the frame was handed over when it was requested, so the buffer holds no copy that has to be deleted
         if (bufferMessageCounter > 0) {
             requestFrame();
         } else {
@@ -61,7 +59,12 @@ void FRTrafficSinkAppBase::handleMessage(cMessage *msg) {
 void FRTrafficSinkAppBase::requestFrame() {
     FRInputBuffer *buffer = dynamic_cast<FRInputBuffer*> (getParentModule()->getSubmodule(
             "inputBuffer"));
-    buffer->deliverNextFrame();
+    //announced frames may have been dropped from a full buffer in the meantime
+    if (buffer->getLength() == 0) {
+        idle = true;
+        return;
+    }
+    buffer->handOverNextFrame();
     idle = false;
 }
 
@@ -16,6 +16,14 @@
 #ifndef FICO4OMNET_DEFS_H
 #define FICO4OMNET_DEFS_H
 
+/**
+ * Headless builds (FICO4OMNET_HEADLESS) compile out all logging. The makefrag defines COMPILETIME_LOGLEVEL on the
+ * command line, this fallback only takes effect if no OMNeT++ header was included before.
+ */
+#if defined(FICO4OMNET_HEADLESS) && !defined(COMPILETIME_LOGLEVEL)
+#  define COMPILETIME_LOGLEVEL omnetpp::LOGLEVEL_OFF
+#endif
+
 //OMNeT++
 #include <omnetpp.h>
 
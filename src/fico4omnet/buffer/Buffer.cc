@@ -29,25 +29,31 @@
 #include "fico4omnet/buffer/Buffer.h"
 #include "fico4omnet/utilities/HelperFunctions.h"
 
+//Std
+#include <cstring>
+#include <iterator>
+
 namespace FiCo4OMNeT {
 
-simsignal_t Buffer::queueLengthSignal = registerSignal("length");
-simsignal_t Buffer::queueSizeSignal = registerSignal("size");
+simsignal_t BufferBase::queueLengthSignal = registerSignal("length");
+simsignal_t BufferBase::queueSizeSignal = registerSignal("size");
+simsignal_t BufferBase::dropSignal = registerSignal("drop");
 
-void Buffer::initialize() {
+void BufferBase::initialize() {
     initializeStatistics();
+    initializeCapacity();
     registerDestinationGate();
     queueSize = 0;
 }
 
-void Buffer::handleMessage(cMessage *msg) {
+void BufferBase::handleMessage(cMessage *msg) {
     if (msg->arrivedOn("in") || msg->arrivedOn("directIn")) {
         recordPacketReceived(msg);
         putFrame(msg);
     }
 }
 
-void Buffer::registerDestinationGate() {
+void BufferBase::registerDestinationGate() {
     destinationGates.clear();
     std::vector<std::string> destinationGatePaths = cStringTokenizer(
             par("destination_gates").stringValue(), ",").asVector();
@@ -71,78 +77,60 @@ void Buffer::registerDestinationGate() {
     }
 }
 
-cMessage* Buffer::getFrame(long objectId) {
-    for (std::list<cMessage*>::iterator it = frames.begin(); it != frames.end();
-            ++it) {
-        cMessage* tmp = *it;
-        long i = tmp->getId();
-        if (i == objectId) {
-            return tmp;
-        }
-    }
-    return nullptr;
-}
-
-void Buffer::putFrame(cMessage* frame) {
-    frames.push_back(frame);
-    emit(queueLengthSignal, static_cast<unsigned long>(frames.size()));
-    if(cPacket* packet = dynamic_cast<cPacket*>(frame))
-    {
-        queueSize+=static_cast<size_t>(packet->getByteLength());
-    }
-    emit(queueSizeSignal, static_cast<unsigned long>(queueSize));
-}
-
-void Buffer::deleteFrame(int objectId) {
-    Enter_Method_Silent
-    ();
-    cMessage *tmp = getFrame(objectId);
-    frames.remove(tmp);
-    emit(queueLengthSignal, static_cast<unsigned long>(frames.size()));
-    if(cPacket* packet = dynamic_cast<cPacket*>(tmp))
-    {
-        queueSize-=static_cast<size_t>(packet->getByteLength());
-    }
-    emit(queueSizeSignal, static_cast<unsigned long>(queueSize));
-    delete tmp;
-}
-
-void Buffer::deliverFrame(int id) {
-    Enter_Method_Silent
-    ();
-    sendToDestinationGates(getFrame(id)->dup());
-}
-
-void Buffer::deliverNextFrame() {
-    Enter_Method_Silent
-    ();
-    sendToDestinationGates(frames.front()->dup());
-}
-
-void Buffer::sendToDestinationGates(cMessage *df) {
+void BufferBase::sendToDestinationGates(cMessage *df) {
     recordPacketSent(df);
 
+    bool outConnected = gate("out")->isConnected();
     for (std::list<cGate*>::const_iterator dgate = destinationGates.begin();
             dgate != destinationGates.end(); ++dgate) {
+        if (!outConnected && std::next(dgate) == destinationGates.end()) {
+            sendDirect(df, 0, 0, *dgate);
+            return;
+        }
         sendDirect(df->dup(), 0, 0, *dgate);
     }
-    if (gate("out")->isConnected()) {
-        send(df->dup(), "out");
+    if (outConnected) {
+        send(df, "out");
+    } else {
+        delete df;
     }
-
-    delete df;
 }
 
-void Buffer::initializeStatistics() {
+void BufferBase::initializeStatistics() {
     txPkSignal = registerSignal("txPk");
     rxPkSignal = registerSignal("rxPk");
 }
 
-void Buffer::recordPacketSent(cMessage *frame) {
+void BufferBase::initializeCapacity() {
+    int frameLimit = par("capacity");
+    int byteLimit = par("byteCapacity");
+    if (frameLimit < 0 || byteLimit < 0) {
+        throw cRuntimeError("The capacity of %s must not be negative.", getFullPath().c_str());
+    }
+    capacity = static_cast<size_t>(frameLimit);
+    byteCapacity = static_cast<size_t>(byteLimit);
+
+    const char *policy = par("dropPolicy").stringValue();
+    if (strcmp(policy, "dropNewest") == 0) {
+        dropPolicy = DropPolicy::DROP_NEWEST;
+    } else if (strcmp(policy, "dropOldest") == 0) {
+        dropPolicy = DropPolicy::DROP_OLDEST;
+    } else if (strcmp(policy, "dropLowestPriority") == 0) {
+        dropPolicy = DropPolicy::DROP_LOWEST_PRIORITY;
+    } else if (strcmp(policy, "overwriteSameId") == 0) {
+        dropPolicy = DropPolicy::OVERWRITE_SAME_ID;
+    } else {
+        throw cRuntimeError(
+                "Unknown drop policy \"%s\". Use dropNewest, dropOldest, dropLowestPriority or overwriteSameId.",
+                policy);
+    }
+}
+
+void BufferBase::recordPacketSent(cMessage *frame) {
     emit(txPkSignal, frame);
 }
 
-void Buffer::recordPacketReceived(cMessage *frame) {
+void BufferBase::recordPacketReceived(cMessage *frame) {
     emit(rxPkSignal, frame);
 }
 
@@ -31,6 +31,11 @@
 
 //FiCo4OMNeT
 #include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+#include "fico4omnet/buffer/IndexedFrameQueue.h"
+
+//Std
+#include <string>
+#include <unordered_map>
 
 namespace FiCo4OMNeT {
 
@@ -39,57 +44,52 @@ using namespace omnetpp;
 /**
  * @brief Represents the content of a physical buffer.
  *
- * Nodes can use the buffers to store incoming or outgoing frames.
+ * Nodes can use the buffers to store incoming or outgoing frames. This class holds the part of the buffer that
+ * does not depend on the frame type, see #Buffer for the storage of the frames.
+ *
+ * The buffer can be bounded in frames and bytes. When a frame does not fit, the drop policy selects the
+ * frame that is dropped.
  *
  * @author Stefan Buschmann
  *
  */
-class Buffer: public cSimpleModule {
+class BufferBase: public cSimpleModule {
 
 public:
     /**
-     * @brief This method registers the gate for the reception of the messages.
+     * @brief Selects the frame that is dropped when a bounded buffer is full.
      */
-    virtual void registerDestinationGate();
+    enum class DropPolicy {
+        DROP_NEWEST, //!< the incoming frame is dropped
+        DROP_OLDEST, //!< the oldest buffered frame is dropped
+        DROP_LOWEST_PRIORITY, //!< the frame with the largest ID is dropped
+        OVERWRITE_SAME_ID //!< the oldest frame with the ID of the incoming frame is dropped, otherwise the incoming frame
+    };
 
     /**
-     *
-     * @brief Searches the buffer for a specific frame.
-     *
-     * @param objectId The unique identifier for the frame that should be searched.
-     *
-     * @return A pointer to the DataFrame with the corresponding object identifier. Returns
-     * null if there is no DataFrame in the buffer.
-     *
+     * @brief Returns true if the buffer has a capacity limit.
      */
-    cMessage* getFrame(long objectId);
+    bool isBounded() const {
+        return capacity != 0 || byteCapacity != 0;
+    }
 
     /**
-     * @brief Puts the frame into the collection #frames.
-     *
-     * @param frame The frame to put in the buffer.
-     *
+     * @brief This method registers the gate for the reception of the messages.
      */
-    virtual void putFrame(cMessage* frame);
+    virtual void registerDestinationGate();
 
     /**
-     * @brief Deletes the frame with the corresponding object identifier from the collection #frames.
+     * @brief Puts the frame into the buffer.
      *
-     * @param objectId The unique identifier for the frame that should be deleted.
-     */
-    void deleteFrame(int objectId);
-
-    /**
-     * @brief Forwards the frame with the corresponding id to all destination gates.
+     * @param frame The frame to put in the buffer.
      *
-     * @param objectId The unique identifier for the frame that should be delivered.
      */
-    void deliverFrame(int objectId);
+    virtual void putFrame(cMessage* frame) = 0;
 
     /**
      * @brief Forwards the first received frame to all destination gates.
      */
-    virtual void deliverNextFrame();
+    virtual void deliverNextFrame() = 0;
 
 protected:
     /**
@@ -107,16 +107,30 @@ protected:
      * was inserted or removed.
      */
     static simsignal_t queueSizeSignal;
+    /**
+     * @brief Signal containing a frame that was dropped because the buffer was full.
+     */
+    static simsignal_t dropSignal;
 
     /**
-     * Stores the Gates to which the messages are delivered.
+     * @brief Maximum number of frames in the buffer, 0 if unlimited.
      */
-    std::list<cGate*> destinationGates;
+    size_t capacity;
 
     /**
-     * @brief Collection for the frames in the Buffer.
+     * @brief Maximum number of bytes in the buffer, 0 if unlimited.
      */
-    std::list<cMessage*> frames;
+    size_t byteCapacity;
+
+    /**
+     * @brief Policy that selects the frame that is dropped when the buffer is full.
+     */
+    DropPolicy dropPolicy;
+
+    /**
+     * Stores the Gates to which the messages are delivered.
+     */
+    std::list<cGate*> destinationGates;
 
     /**
      * Signal that is emitted every time a frame was sent.
@@ -159,6 +173,8 @@ protected:
     /**
      * @brief The message is delivered to the destination.
      *
+     * The last destination receives the message itself, all others a copy.
+     *
      * @param msg the message to be sent
      */
     virtual void sendToDestinationGates(cMessage *msg);
@@ -168,6 +184,289 @@ private:
      * Initializes the statistics for the module
      */
     void initializeStatistics();
+
+    /**
+     * Initializes the capacity limits and the drop policy
+     */
+    void initializeCapacity();
+};
+
+/**
+ * @brief Buffer that stores frames of a specific type.
+ *
+ * The frames are kept in an #IndexedFrameQueue, so looking up and removing a frame by its key or object
+ * identifier does not depend on the number of buffered frames.
+ *
+ * @tparam FrameT type of the buffered frames, derived from cPacket
+ * @tparam KeyOf provides the key type (KeyOf::Key) and the key of a frame (KeyOf::key(const FrameT*))
+ *
+ * @author Stefan Buschmann
+ *
+ */
+template<typename FrameT, typename KeyOf>
+class Buffer: public BufferBase {
+
+public:
+    typedef typename KeyOf::Key Key;
+
+    /**
+     * @brief Searches the buffer for the oldest frame with a specific key.
+     *
+     * @param key The key of the frame that should be searched.
+     *
+     * @return A pointer to the frame with the corresponding key. Returns
+     * null if there is no such frame in the buffer.
+     */
+    FrameT* getFrame(Key key) {
+        return frames.find(key);
+    }
+
+    /**
+     *
+     * @brief Searches the buffer for a specific frame.
+     *
+     * @param objectId The unique identifier for the frame that should be searched.
+     *
+     * @return A pointer to the frame with the corresponding object identifier. Returns
+     * null if there is no such frame in the buffer.
+     *
+     */
+    FrameT* getFrameByObjectId(long objectId) {
+        return frames.findByObjectId(objectId);
+    }
+
+    /**
+     * @brief Puts the frame into the collection #frames if the capacity limits permit it.
+     *
+     * @param msg The frame to put in the buffer.
+     *
+     */
+    virtual void putFrame(cMessage* msg) {
+        FrameT *frame = check_and_cast<FrameT *>(msg);
+        if (admit(frame)) {
+            enqueue(frame);
+        } else {
+            rejectFrame(frame);
+        }
+    }
+
+    /**
+     * @brief Returns the number of buffered frames.
+     */
+    size_t getLength() const {
+        return frames.size();
+    }
+
+    /**
+     * @brief Deletes the oldest frame with the key from the collection #frames.
+     *
+     * @param key The key of the frame that should be deleted.
+     */
+    void deleteFrame(Key key) {
+        Enter_Method_Silent();
+        deleteFrame(frames.find(key));
+    }
+
+    /**
+     * @brief Deletes the frame from the collection #frames.
+     *
+     * @param frame The frame that should be deleted.
+     */
+    void deleteFrame(FrameT* frame) {
+        Enter_Method_Silent();
+        if (dequeue(frame)) {
+            delete frame;
+        }
+    }
+
+    /**
+     * @brief Forwards a copy of the first received frame to all destination gates. The frame stays in the buffer.
+     */
+    virtual void deliverNextFrame() {
+        Enter_Method_Silent();
+        if (FrameT *frame = frames.front()) {
+            sendToDestinationGates(frame->dup());
+        }
+    }
+
+    /**
+     * @brief Hands the first received frame over to the destination gates and removes it from the buffer.
+     *
+     * The receiver takes the ownership of the frame, see #handOverFrame.
+     */
+    void handOverNextFrame() {
+        Enter_Method_Silent();
+        handOverFrame(frames.front());
+    }
+
+protected:
+    /**
+     * @brief Collection for the frames in the Buffer.
+     */
+    IndexedFrameQueue<FrameT, KeyOf> frames;
+
+    /**
+     * @brief Initialization of the buffer. The ordered key index of #frames is kept for the drop policy
+     * DROP_LOWEST_PRIORITY.
+     */
+    virtual void initialize() {
+        BufferBase::initialize();
+        frames.setKeyOrder(dropPolicy == DropPolicy::DROP_LOWEST_PRIORITY);
+    }
+
+    /**
+     * @brief Appends the frame to the collection #frames and emits the queue statistics.
+     *
+     * @param frame The frame to put in the buffer.
+     */
+    void enqueue(FrameT* frame) {
+        frames.push_back(frame);
+        emit(queueLengthSignal, static_cast<unsigned long>(frames.size()));
+        queueSize+=static_cast<size_t>(frame->getByteLength());
+        emit(queueSizeSignal, static_cast<unsigned long>(queueSize));
+    }
+
+    /**
+     * @brief Removes the frame from the collection #frames and emits the queue statistics. The frame is not deleted.
+     *
+     * @param frame The frame to remove.
+     *
+     * @return true if the frame was in the buffer
+     */
+    bool dequeue(FrameT* frame) {
+        if (!frames.remove(frame)) {
+            return false;
+        }
+        emit(queueLengthSignal, static_cast<unsigned long>(frames.size()));
+        queueSize-=static_cast<size_t>(frame->getByteLength());
+        emit(queueSizeSignal, static_cast<unsigned long>(queueSize));
+        return true;
+    }
+
+    /**
+     * @brief Removes the frame from the buffer and hands it over to the destination gates.
+     *
+     * The last destination receives the stored frame itself, only additional destinations receive copies.
+     *
+     * @param frame The buffered frame, nothing happens for nullptr.
+     */
+    void handOverFrame(FrameT* frame) {
+        if (frame != nullptr && dequeue(frame)) {
+            sendToDestinationGates(frame);
+        }
+    }
+
+    /**
+     * @brief Makes room for the frame according to the capacity limits and the drop policy.
+     *
+     * Buffered frames that are selected by the drop policy are dropped with #dropFrame.
+     *
+     * @param frame The incoming frame.
+     *
+     * @return true if the frame fits into the buffer, false if the incoming frame has to be dropped
+     */
+    bool admit(FrameT* frame) {
+        if (!isBounded()) {
+            return true;
+        }
+        size_t bytes = static_cast<size_t>(frame->getByteLength());
+        if (byteCapacity != 0 && bytes > byteCapacity) {
+            return false;
+        }
+        while ((capacity != 0 && frames.size() >= capacity)
+                || (byteCapacity != 0 && queueSize + bytes > byteCapacity)) {
+            FrameT *victim = nullptr;
+            switch (dropPolicy) {
+            case DropPolicy::DROP_OLDEST:
+                if (!dropOldest()) {
+                    return false;
+                }
+                continue;
+            case DropPolicy::DROP_LOWEST_PRIORITY:
+                victim = frames.findLargestKey();
+                if (victim != nullptr && !(KeyOf::key(frame) < KeyOf::key(victim))) {
+                    victim = nullptr;
+                }
+                break;
+            case DropPolicy::OVERWRITE_SAME_ID:
+                victim = frames.find(KeyOf::key(frame));
+                break;
+            case DropPolicy::DROP_NEWEST:
+                break;
+            }
+            if (victim == nullptr || !dropFrame(victim)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Drops the oldest buffered frame that may be dropped.
+     *
+     * Frames that #dropFrame refuses, e.g. the frame that is transmitted, are skipped.
+     *
+     * @return true if a frame was dropped
+     */
+    bool dropOldest() {
+        for (typename IndexedFrameQueue<FrameT, KeyOf>::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+            if (dropFrame(*it)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Drops a buffered frame to make room for an incoming frame.
+     *
+     * Subclasses can refuse to drop frames that are in use, e.g. while they are transmitted.
+     *
+     * @param frame The buffered frame.
+     *
+     * @return true if the frame was dropped
+     */
+    virtual bool dropFrame(FrameT* frame) {
+        if (!dequeue(frame)) {
+            return false;
+        }
+        recordDrop(frame);
+        delete frame;
+        return true;
+    }
+
+    /**
+     * @brief Drops an incoming frame that did not fit into the buffer.
+     *
+     * @param frame The incoming frame.
+     */
+    void rejectFrame(FrameT* frame) {
+        recordDrop(frame);
+        delete frame;
+    }
+
+private:
+    /**
+     * @brief Signals for dropped frames per key.
+     */
+    std::unordered_map<Key, simsignal_t> dropSignals;
+
+    /**
+     * @brief Emits the drop signals of the frame.
+     */
+    void recordDrop(FrameT* frame) {
+        emit(dropSignal, frame);
+        Key key = KeyOf::key(frame);
+        typename std::unordered_map<Key, simsignal_t>::iterator it = dropSignals.find(key);
+        if (it == dropSignals.end()) {
+            std::string name = "drop-" + std::to_string(key);
+            simsignal_t signal = registerSignal(name.c_str());
+            getEnvir()->addResultRecorders(this, signal, name.c_str(),
+                    getProperties()->get("statisticTemplate", "dropPerId"));
+            it = dropSignals.insert(std::make_pair(key, signal)).first;
+        }
+        emit(it->second, frame);
+    }
 };
 
 }
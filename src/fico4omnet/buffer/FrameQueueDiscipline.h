@@ -0,0 +1,441 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_FRAMEQUEUEDISCIPLINE_H_
+#define FICO4OMNET_FRAMEQUEUEDISCIPLINE_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+#include "fico4omnet/buffer/IndexedFrameQueue.h"
+
+//Std
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace FiCo4OMNeT {
+
+using namespace omnetpp;
+
+/**
+ * @brief Queueing discipline that decides in which order the frames of a buffer are transmitted.
+ *
+ * The discipline does not own the frames.
+ *
+ * @tparam FrameT type of the frames, derived from cMessage
+ * @tparam KeyOf provides the key type (KeyOf::Key) and the key of a frame (KeyOf::key(const FrameT*))
+ *
+ * @ingroup Buffer
+ */
+template<typename FrameT, typename KeyOf>
+class FrameQueueDiscipline {
+
+public:
+    virtual ~FrameQueueDiscipline() {
+    }
+
+    /**
+     * @brief Inserts the frame.
+     *
+     * @param frame the frame
+     * @param deadline time until the frame should be transmitted
+     *
+     * @return a frame that was displaced by the new frame or nullptr. The caller has to delete the displaced frame.
+     */
+    virtual FrameT* push(FrameT *frame, simtime_t deadline) = 0;
+
+    /**
+     * @brief Returns the frame that is transmitted next.
+     *
+     * @return the next frame or nullptr if the discipline holds no frames
+     */
+    virtual FrameT* front() const = 0;
+
+    /**
+     * @brief Removes the frame that is transmitted next.
+     *
+     * @return the removed frame or nullptr if the discipline holds no frames
+     */
+    virtual FrameT* pop() = 0;
+
+    /**
+     * @brief Removes the frame.
+     *
+     * @param frame the frame
+     *
+     * @return true if the frame was held by the discipline
+     */
+    virtual bool remove(FrameT *frame) = 0;
+
+    /**
+     * @brief Returns the number of frames held by the discipline.
+     */
+    virtual size_t size() const = 0;
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Creates the discipline with the name.
+     *
+     * @param name "fifo", "priority", "mailbox" or "edf"
+     *
+     * @return the new discipline, the caller takes the ownership
+     */
+    static FrameQueueDiscipline* create(const char *name);
+};
+
+/**
+ * @brief Binary heap of frames with an index on the object ID, so that any frame can be removed in logarithmic time.
+ *
+ * Frames with the same sort key are kept in insertion order.
+ *
+ * @tparam FrameT type of the frames, derived from cMessage
+ * @tparam SortKey type of the sort key, the smallest key is at the top
+ *
+ * @ingroup Buffer
+ */
+template<typename FrameT, typename SortKey>
+class IndexedFrameHeap {
+
+public:
+    IndexedFrameHeap() :
+            sequence(0) {
+    }
+
+    /**
+     * @brief Inserts the frame.
+     *
+     * @param frame the frame, must not already be in the heap
+     * @param key the sort key of the frame
+     */
+    void push(FrameT *frame, SortKey key) {
+        Entry entry;
+        entry.frame = frame;
+        entry.key = key;
+        entry.sequence = sequence++;
+        heap.push_back(entry);
+        positions[frame->getId()] = heap.size() - 1;
+        siftUp(heap.size() - 1);
+    }
+
+    FrameT* front() const {
+        return heap.empty() ? nullptr : heap.front().frame;
+    }
+
+    FrameT* pop() {
+        if (heap.empty()) {
+            return nullptr;
+        }
+        FrameT *frame = heap.front().frame;
+        removeAt(0);
+        return frame;
+    }
+
+    bool remove(FrameT *frame) {
+        if (frame == nullptr) {
+            return false;
+        }
+        typename std::unordered_map<long, size_t>::iterator it = positions.find(frame->getId());
+        if (it == positions.end() || heap[it->second].frame != frame) {
+            return false;
+        }
+        removeAt(it->second);
+        return true;
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+private:
+    /**
+     * @brief Frame in the heap.
+     */
+    struct Entry {
+        FrameT *frame;
+        SortKey key;
+        uint64_t sequence;
+
+        bool operator<(const Entry &other) const {
+            if (key < other.key) {
+                return true;
+            }
+            if (other.key < key) {
+                return false;
+            }
+            return sequence < other.sequence;
+        }
+    };
+
+    void removeAt(size_t index) {
+        positions.erase(heap[index].frame->getId());
+        size_t last = heap.size() - 1;
+        if (index != last) {
+            heap[index] = heap[last];
+            positions[heap[index].frame->getId()] = index;
+        }
+        heap.pop_back();
+        if (index < heap.size()) {
+            siftUp(index);
+            siftDown(index);
+        }
+    }
+
+    void siftUp(size_t index) {
+        while (index > 0) {
+            size_t parent = (index - 1) / 2;
+            if (!(heap[index] < heap[parent])) {
+                break;
+            }
+            swapEntries(index, parent);
+            index = parent;
+        }
+    }
+
+    void siftDown(size_t index) {
+        for (;;) {
+            size_t smallest = index;
+            size_t left = 2 * index + 1;
+            size_t right = left + 1;
+            if (left < heap.size() && heap[left] < heap[smallest]) {
+                smallest = left;
+            }
+            if (right < heap.size() && heap[right] < heap[smallest]) {
+                smallest = right;
+            }
+            if (smallest == index) {
+                break;
+            }
+            swapEntries(index, smallest);
+            index = smallest;
+        }
+    }
+
+    void swapEntries(size_t a, size_t b) {
+        std::swap(heap[a], heap[b]);
+        positions[heap[a].frame->getId()] = a;
+        positions[heap[b].frame->getId()] = b;
+    }
+
+    /**
+     * @brief The heap, the smallest entry is at the front.
+     */
+    std::vector<Entry> heap;
+
+    /**
+     * @brief Position of the frames in the heap indexed by their object ID.
+     */
+    std::unordered_map<long, size_t> positions;
+
+    /**
+     * @brief Insertion counter to keep frames with the same sort key in FIFO order.
+     */
+    uint64_t sequence;
+};
+
+/**
+ * @brief First in, first out.
+ *
+ * @ingroup Buffer
+ */
+template<typename FrameT, typename KeyOf>
+class FifoQueueDiscipline: public FrameQueueDiscipline<FrameT, KeyOf> {
+
+public:
+    virtual FrameT* push(FrameT *frame, simtime_t deadline) {
+        (void) deadline;
+        frames.push_back(frame);
+        return nullptr;
+    }
+
+    virtual FrameT* front() const {
+        return frames.front();
+    }
+
+    virtual FrameT* pop() {
+        FrameT *frame = frames.front();
+        frames.remove(frame);
+        return frame;
+    }
+
+    virtual bool remove(FrameT *frame) {
+        return frames.remove(frame);
+    }
+
+    virtual size_t size() const {
+        return frames.size();
+    }
+
+private:
+    IndexedFrameQueue<FrameT, KeyOf> frames;
+};
+
+/**
+ * @brief Strict priority, the frame with the smallest key is transmitted first.
+ *
+ * @ingroup Buffer
+ */
+template<typename FrameT, typename KeyOf>
+class PriorityQueueDiscipline: public FrameQueueDiscipline<FrameT, KeyOf> {
+
+public:
+    virtual FrameT* push(FrameT *frame, simtime_t deadline) {
+        (void) deadline;
+        heap.push(frame, KeyOf::key(frame));
+        return nullptr;
+    }
+
+    virtual FrameT* front() const {
+        return heap.front();
+    }
+
+    virtual FrameT* pop() {
+        return heap.pop();
+    }
+
+    virtual bool remove(FrameT *frame) {
+        return heap.remove(frame);
+    }
+
+    virtual size_t size() const {
+        return heap.size();
+    }
+
+private:
+    IndexedFrameHeap<FrameT, typename KeyOf::Key> heap;
+};
+
+/**
+ * @brief One mailbox per key that holds only the newest frame, the mailbox with the smallest key is transmitted first.
+ *
+ * @ingroup Buffer
+ */
+template<typename FrameT, typename KeyOf>
+class MailboxQueueDiscipline: public FrameQueueDiscipline<FrameT, KeyOf> {
+
+public:
+    virtual FrameT* push(FrameT *frame, simtime_t deadline) {
+        (void) deadline;
+        FrameT *&slot = mailboxes[KeyOf::key(frame)];
+        FrameT *displaced = slot;
+        if (displaced != nullptr) {
+            heap.remove(displaced);
+        }
+        slot = frame;
+        heap.push(frame, KeyOf::key(frame));
+        return displaced;
+    }
+
+    virtual FrameT* front() const {
+        return heap.front();
+    }
+
+    virtual FrameT* pop() {
+        FrameT *frame = heap.pop();
+        if (frame != nullptr) {
+            mailboxes[KeyOf::key(frame)] = nullptr;
+        }
+        return frame;
+    }
+
+    virtual bool remove(FrameT *frame) {
+        if (!heap.remove(frame)) {
+            return false;
+        }
+        mailboxes[KeyOf::key(frame)] = nullptr;
+        return true;
+    }
+
+    virtual size_t size() const {
+        return heap.size();
+    }
+
+private:
+    IndexedFrameHeap<FrameT, typename KeyOf::Key> heap;
+
+    /**
+     * @brief Occupied mailboxes indexed by the key.
+     */
+    std::unordered_map<typename KeyOf::Key, FrameT*> mailboxes;
+};
+
+/**
+ * @brief Earliest deadline first.
+ *
+ * @ingroup Buffer
+ */
+template<typename FrameT, typename KeyOf>
+class EdfQueueDiscipline: public FrameQueueDiscipline<FrameT, KeyOf> {
+
+public:
+    virtual FrameT* push(FrameT *frame, simtime_t deadline) {
+        heap.push(frame, deadline);
+        return nullptr;
+    }
+
+    virtual FrameT* front() const {
+        return heap.front();
+    }
+
+    virtual FrameT* pop() {
+        return heap.pop();
+    }
+
+    virtual bool remove(FrameT *frame) {
+        return heap.remove(frame);
+    }
+
+    virtual size_t size() const {
+        return heap.size();
+    }
+
+private:
+    IndexedFrameHeap<FrameT, simtime_t> heap;
+};
+
+template<typename FrameT, typename KeyOf>
+FrameQueueDiscipline<FrameT, KeyOf>* FrameQueueDiscipline<FrameT, KeyOf>::create(const char *name) {
+    if (strcmp(name, "fifo") == 0) {
+        return new FifoQueueDiscipline<FrameT, KeyOf>();
+    } else if (strcmp(name, "priority") == 0) {
+        return new PriorityQueueDiscipline<FrameT, KeyOf>();
+    } else if (strcmp(name, "mailbox") == 0) {
+        return new MailboxQueueDiscipline<FrameT, KeyOf>();
+    } else if (strcmp(name, "edf") == 0) {
+        return new EdfQueueDiscipline<FrameT, KeyOf>();
+    }
+    throw cRuntimeError("Unknown queue discipline \"%s\". Use fifo, priority, mailbox or edf.", name);
+}
+
+}
+
+#endif
@@ -0,0 +1,389 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_INDEXEDFRAMEQUEUE_H_
+#define FICO4OMNET_INDEXEDFRAMEQUEUE_H_
+
+//Std
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+
+namespace FiCo4OMNeT {
+
+/**
+ * @brief FIFO queue of typed frames with hash indexes on the object ID and on a frame key.
+ *
+ * Every frame is stored in a list node that is linked into the FIFO order of all frames and into the FIFO order
+ * of the frames with the same key. Inserting, finding the first frame with a key and removing a frame are
+ * therefore constant time operations while the order of the frames is kept. Removed list nodes are kept in a free
+ * list and reused, so the queue only allocates list nodes until it reached its largest size.
+ *
+ * The queue does not own the frames.
+ *
+ * @tparam FrameT type of the frames, derived from cMessage
+ * @tparam KeyOf provides the key type (KeyOf::Key) and the key of a frame (KeyOf::key(const FrameT*))
+ *
+ * @ingroup Buffer
+ */
+template<typename FrameT, typename KeyOf>
+class IndexedFrameQueue {
+
+public:
+    typedef typename KeyOf::Key Key;
+
+private:
+    /**
+     * @brief List node of a frame.
+     */
+    struct Node {
+        FrameT *frame;
+        Node *prev;
+        Node *next;
+        Node *prevSameKey;
+        Node *nextSameKey;
+    };
+
+    /**
+     * @brief First and last node of the frames with the same key.
+     */
+    struct KeyChain {
+        Node *head;
+        Node *tail;
+    };
+
+public:
+    /**
+     * @brief Iterator over the frames in FIFO order.
+     */
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef FrameT* value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef FrameT* const* pointer;
+        typedef FrameT* reference;
+
+        explicit const_iterator(const Node *setNode = nullptr) :
+                node(setNode) {
+        }
+        FrameT* operator*() const {
+            return node->frame;
+        }
+        const_iterator& operator++() {
+            node = node->next;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            node = node->next;
+            return previous;
+        }
+        bool operator==(const const_iterator &other) const {
+            return node == other.node;
+        }
+        bool operator!=(const const_iterator &other) const {
+            return node != other.node;
+        }
+    private:
+        const Node *node;
+    };
+
+    IndexedFrameQueue() :
+            head(nullptr), tail(nullptr), freeNodes(nullptr), count(0), keyOrder(false) {
+    }
+
+    ~IndexedFrameQueue() {
+        clear();
+        while (freeNodes != nullptr) {
+            Node *next = freeNodes->next;
+            delete freeNodes;
+            freeNodes = next;
+        }
+    }
+
+    /**
+     * @brief Appends the frame at the end of the queue.
+     *
+     * @param frame the frame, must not already be in the queue
+     */
+    void push_back(FrameT *frame) {
+        Node *node = acquireNode();
+        node->frame = frame;
+        node->prev = tail;
+        node->next = nullptr;
+        if (tail != nullptr) {
+            tail->next = node;
+        } else {
+            head = node;
+        }
+        tail = node;
+
+        KeyChain &chain = byKey[KeyOf::key(frame)];
+        node->prevSameKey = chain.tail;
+        node->nextSameKey = nullptr;
+        if (chain.tail != nullptr) {
+            chain.tail->nextSameKey = node;
+        } else {
+            chain.head = node;
+        }
+        chain.tail = node;
+
+        byObjectId[frame->getId()] = node;
+        if (keyOrder) {
+            orderedKeys[KeyOf::key(frame)]++;
+        }
+        count++;
+    }
+
+    /**
+     * @brief Enables the ordered index of the keys used by #findLargestKey.
+     *
+     * The index costs a tree operation per inserted and removed frame, so it is only kept if it is enabled.
+     *
+     * @param enabled true to keep the ordered index, must be set while the queue is empty
+     */
+    void setKeyOrder(bool enabled) {
+        keyOrder = enabled;
+        orderedKeys.clear();
+    }
+
+    /**
+     * @brief Returns the first frame with the key.
+     *
+     * @param key the key
+     * @return the first frame with the key in FIFO order or nullptr if there is none
+     */
+    FrameT* find(Key key) const {
+        typename std::unordered_map<Key, KeyChain>::const_iterator it = byKey.find(key);
+        if (it == byKey.end() || it->second.head == nullptr) {
+            return nullptr;
+        }
+        return it->second.head->frame;
+    }
+
+    /**
+     * @brief Returns the newest frame with the largest key.
+     *
+     * Uses the ordered index if it is enabled (#setKeyOrder), otherwise all keys that were used in the queue are
+     * scanned.
+     *
+     * @return the newest frame with the largest key or nullptr if the queue is empty
+     */
+    FrameT* findLargestKey() const {
+        if (keyOrder) {
+            if (orderedKeys.empty()) {
+                return nullptr;
+            }
+            return byKey.find(orderedKeys.rbegin()->first)->second.tail->frame;
+        }
+        const Node *largest = nullptr;
+        for (typename std::unordered_map<Key, KeyChain>::const_iterator it = byKey.begin(); it != byKey.end(); ++it) {
+            if (it->second.tail != nullptr && (largest == nullptr || KeyOf::key(largest->frame) < it->first)) {
+                largest = it->second.tail;
+            }
+        }
+        return largest != nullptr ? largest->frame : nullptr;
+    }
+
+    /**
+     * @brief Returns the frame with the object ID.
+     *
+     * @param objectId the object ID of the frame
+     * @return the frame or nullptr if it is not in the queue
+     */
+    FrameT* findByObjectId(long objectId) const {
+        typename std::unordered_map<long, Node*>::const_iterator it = byObjectId.find(objectId);
+        return it != byObjectId.end() ? it->second->frame : nullptr;
+    }
+
+    /**
+     * @brief Removes the frame from the queue.
+     *
+     * @param frame the frame to remove
+     * @return true if the frame was in the queue
+     */
+    bool remove(FrameT *frame) {
+        if (frame == nullptr) {
+            return false;
+        }
+        typename std::unordered_map<long, Node*>::iterator it = byObjectId.find(frame->getId());
+        if (it == byObjectId.end() || it->second->frame != frame) {
+            return false;
+        }
+        Node *node = it->second;
+        byObjectId.erase(it);
+
+        if (node->prev != nullptr) {
+            node->prev->next = node->next;
+        } else {
+            head = node->next;
+        }
+        if (node->next != nullptr) {
+            node->next->prev = node->prev;
+        } else {
+            tail = node->prev;
+        }
+
+        //empty chains are kept so that frequently used keys do not allocate
+        KeyChain &chain = byKey[KeyOf::key(frame)];
+        if (node->prevSameKey != nullptr) {
+            node->prevSameKey->nextSameKey = node->nextSameKey;
+        } else {
+            chain.head = node->nextSameKey;
+        }
+        if (node->nextSameKey != nullptr) {
+            node->nextSameKey->prevSameKey = node->prevSameKey;
+        } else {
+            chain.tail = node->prevSameKey;
+        }
+        if (keyOrder) {
+            typename std::map<Key, size_t>::iterator ordered = orderedKeys.find(KeyOf::key(frame));
+            if (--ordered->second == 0) {
+                orderedKeys.erase(ordered);
+            }
+        }
+
+        releaseNode(node);
+        count--;
+        return true;
+    }
+
+    /**
+     * @brief Removes all frames from the queue. The frames are not deleted.
+     */
+    void clear() {
+        Node *node = head;
+        while (node != nullptr) {
+            Node *next = node->next;
+            releaseNode(node);
+            node = next;
+        }
+        head = nullptr;
+        tail = nullptr;
+        count = 0;
+        byKey.clear();
+        byObjectId.clear();
+        orderedKeys.clear();
+    }
+
+    /**
+     * @brief Returns the first frame of the queue.
+     *
+     * @return the oldest frame or nullptr if the queue is empty
+     */
+    FrameT* front() const {
+        return head != nullptr ? head->frame : nullptr;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    const_iterator begin() const {
+        return const_iterator(head);
+    }
+
+    const_iterator end() const {
+        return const_iterator(nullptr);
+    }
+
+private:
+    IndexedFrameQueue(const IndexedFrameQueue&);
+    IndexedFrameQueue& operator=(const IndexedFrameQueue&);
+
+    /**
+     * @brief Returns a node from the free list or allocates a new one.
+     */
+    Node* acquireNode() {
+        if (freeNodes == nullptr) {
+            return new Node();
+        }
+        Node *node = freeNodes;
+        freeNodes = node->next;
+        return node;
+    }
+
+    /**
+     * @brief Puts the node on the free list.
+     */
+    void releaseNode(Node *node) {
+        node->frame = nullptr;
+        node->next = freeNodes;
+        freeNodes = node;
+    }
+
+    /**
+     * @brief Oldest frame.
+     */
+    Node *head;
+
+    /**
+     * @brief Newest frame.
+     */
+    Node *tail;
+
+    /**
+     * @brief Unused nodes, linked by their next pointer.
+     */
+    Node *freeNodes;
+
+    /**
+     * @brief Number of frames in the queue.
+     */
+    size_t count;
+
+    /**
+     * @brief Frames indexed by their key.
+     */
+    std::unordered_map<Key, KeyChain> byKey;
+
+    /**
+     * @brief Frames indexed by their object ID.
+     */
+    std::unordered_map<long, Node*> byObjectId;
+
+    /**
+     * @brief True if #orderedKeys is kept.
+     */
+    bool keyOrder;
+
+    /**
+     * @brief Number of frames per key, ordered by the key. Only kept if #keyOrder is set.
+     */
+    std::map<Key, size_t> orderedKeys;
+};
+
+}
+
+#endif
@@ -36,72 +36,12 @@ void CanBuffer::initialize(){
     currentFrame = nullptr;
 }
 
-CanDataFrame* CanBuffer::getFrame(unsigned int canID) {
-    for (std::list<cMessage*>::iterator it = frames.begin();
-            it != frames.end(); ++it) {
-        CanDataFrame* tmp = dynamic_cast<CanDataFrame*>(*it);
-        unsigned int i = tmp->getCanID();
-        if (i == canID) {
-            return tmp;
-        }
-    }
-    return nullptr;
-}
-
-void CanBuffer::putFrame(cMessage* msg){
-    CanDataFrame *frame = check_and_cast<CanDataFrame *>(msg);
-    frames.push_back(frame);
-    emit(queueLengthSignal, static_cast<unsigned long>(frames.size()));
-    queueSize+=static_cast<size_t>(frame->getByteLength());
-    emit(queueSizeSignal, static_cast<unsigned long>(queueSize));
-}
-
-void CanBuffer::deleteFrame(unsigned int canID) {
-    Enter_Method_Silent();
-    CanDataFrame *tmp = getFrame(canID);
-    frames.remove(tmp);
-    emit(queueLengthSignal, static_cast<unsigned long>(frames.size()));
-    queueSize-=static_cast<size_t>(tmp->getByteLength());
-    emit(queueSizeSignal, static_cast<unsigned long>(queueSize));
-    delete tmp;
-}
-
-void CanBuffer::deleteFrame(CanDataFrame* frame) {
-    Enter_Method_Silent();
-    frames.remove(frame);
-    emit(queueLengthSignal, static_cast<unsigned long>(frames.size()));
-    queueSize-=static_cast<size_t>(frame->getByteLength());
-    emit(queueSizeSignal, static_cast<unsigned long>(queueSize));
-    delete frame;
-}
-
 void CanBuffer::deliverFrame(unsigned int canID) {
     Enter_Method_Silent();
     currentFrame = getFrame(canID);
     sendToDestinationGates(currentFrame->dup());
 }
 
-void CanBuffer::deliverPrioFrame() {
-    Enter_Method_Silent();
-    unsigned int prioId = INT_MAX;
-    CanDataFrame *prioFrame = nullptr;
-    for (std::list<cMessage*>::iterator it = frames.begin();
-            it != frames.end(); ++it) {
-        CanDataFrame *tmp = dynamic_cast<CanDataFrame*>(*it);
-        unsigned int i = tmp->getCanID();
-        if ((i < prioId)) {
-            prioFrame = tmp;
-            prioId = i;
-        }
-    }
-    sendToDestinationGates(prioFrame->dup());
-}
-
-void CanBuffer::deliverNextFrame() {
-    Enter_Method_Silent();
-    sendToDestinationGates(frames.front()->dup());
-}
-
 CanDataFrame* CanBuffer::getCurrentFrame(){
     return currentFrame;
 }
@@ -34,10 +34,21 @@
 #include "fico4omnet/buffer/Buffer.h"
 
 //Auto-generated messages
-#include "fico4omnet/linklayer/can/messages/CanDataFrame_m.h"
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
 
 namespace FiCo4OMNeT {
 
+/**
+ * @brief Key of the can frames in the #CanBuffer.
+ */
+struct CanFrameKey {
+    typedef unsigned int Key;
+
+    static Key key(const CanDataFrame *frame) {
+        return frame->getCanID();
+    }
+};
+
 /**
  * @brief Base class for the input and output buffer for CAN nodes.
  *
@@ -45,53 +56,14 @@ namespace FiCo4OMNeT {
  *
  * @author Stefan Buschmann
  */
-class CanBuffer: public Buffer {
+class CanBuffer: public Buffer<CanDataFrame, CanFrameKey> {
 
 public:
-    /**
-     * @brief Searches the collection for a frame with a specific can ID.
-     *
-     * @param canID The can ID of the frame that should be searched in the buffer.
-     *
-     * @return A pointer to the DataFrame with the corresponding can ID. Returns
-     * null if there is no DataFrame in the buffer.
-     *
-     */
-    CanDataFrame* getFrame(unsigned int canID);
-
-    /**
-     * @brief Puts the can frame into the collection.
-     *
-     * @param msg The frame to put in the buffer.
-     *
-     */
-    virtual void putFrame(cMessage* msg);
-
-    /**
-     * @brief Deletes the frame with the corresponding can id from the #frames collection.
-     */
-    void deleteFrame(unsigned int canID);
-
-    /**
-     * @brief Deletes the frame from the #frames collection.
-     */
-    void deleteFrame(CanDataFrame* frame);
-
     /**
      * @brief Forwards the frame with the corresponding can id to all destination gates.
      */
     void deliverFrame(unsigned int canID);
 
-    /**
-     * @brief Forwards the frame with the highest priority to all destination gates.
-     */
-    virtual void deliverPrioFrame();
-
-    /**
-     * @brief Forwards the first received frame to all destination gates.
-     */
-    virtual void deliverNextFrame();
-
     /**
      * @brief Returns the frame which is currently transmitted.
      *
@@ -54,7 +54,26 @@ void CanInputBuffer::registerIncomingDataFramesAtPort() {
 }
 
 void CanInputBuffer::putFrame(cMessage* msg) {
-    CanDataFrame *frame = dynamic_cast<CanDataFrame *>(msg);
+    CanDataFrame *frame = check_and_cast<CanDataFrame *>(msg);
+    if (isReceiveFifo()) {
+        bool overwritten = false;
+        if (MOB == true) {
+            CanDataFrame *oldFrame = getFrame(frame->getCanID());
+            if (oldFrame != nullptr) {
+                deleteFrame(oldFrame);
+                overwritten = true;
+            }
+        }
+        if (!admit(frame)) {
+            rejectFrame(frame);
+            return;
+        }
+        enqueue(frame);
+        if (!overwritten) {
+            notifySinkApps();
+        }
+        return;
+    }
     if (MOB == true) {
         if (getFrame(frame->getCanID()) != nullptr) {
             deleteFrame(frame->getCanID());
@@ -66,4 +85,24 @@ void CanInputBuffer::putFrame(cMessage* msg) {
     }
 }
 
+void CanInputBuffer::deliverNextFrame() {
+    Enter_Method_Silent
+    ();
+    if (!isReceiveFifo()) {
+        CanBuffer::deliverNextFrame();
+        return;
+    }
+    handOverFrame(frames.front());
+}
+
+void CanInputBuffer::notifySinkApps() {
+    for (std::list<cGate*>::const_iterator dgate = destinationGates.begin();
+            dgate != destinationGates.end(); ++dgate) {
+        cModule *sinkApp = (*dgate)->getOwnerModule();
+        if (sinkApp->hasGate("controllerIn")) {
+            sendDirect(new cMessage("Message in buffer"), sinkApp, "controllerIn");
+        }
+    }
+}
+
 }
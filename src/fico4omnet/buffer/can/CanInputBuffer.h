@@ -38,6 +38,10 @@ namespace FiCo4OMNeT {
 /**
  * @brief This buffer holds messages which were received by this node.
  *
+ * An unbounded buffer forwards the received frames to the sink applications at once. A bounded buffer models the
+ * receive FIFO of the CAN controller: the frames are kept until a sink application reads them with
+ * #deliverNextFrame, frames that do not fit are dropped according to the drop policy.
+ *
  * @ingroup Buffer
  *
  * @author Stefan Buschmann
@@ -53,6 +57,21 @@ public:
      */
     virtual void putFrame(cMessage* msg);
 
+    /**
+     * @brief Forwards the first received frame to all destination gates.
+     *
+     * In a receive FIFO reading the frame releases its slot, so the frame is handed over to the sink application
+     * instead of a copy.
+     */
+    virtual void deliverNextFrame();
+
+    /**
+     * @brief Returns true if the buffer keeps the frames until they are read, see #isBounded.
+     */
+    bool isReceiveFifo() const {
+        return isBounded();
+    }
+
 protected:
     /**
      * @brief Initialization of the module.
@@ -64,6 +83,11 @@ private:
      * @brief Registers the can IDs which will be received by this node.
      */
     void registerIncomingDataFramesAtPort();
+
+    /**
+     * @brief Informs the sink applications that a frame was put into the receive FIFO.
+     */
+    void notifySinkApps();
 };
 
 }
@@ -30,49 +30,293 @@
 
 #include "fico4omnet/bus/can/CanBusLogic.h"
 #include "fico4omnet/linklayer/can/CanPortOutput.h"
+#include "fico4omnet/utilities/HelperFunctions.h"
+
+//Std
+#include <string>
 
 namespace FiCo4OMNeT {
 
 Define_Module(CanOutputBuffer);
 
+simsignal_t CanOutputBuffer::priorityInversionSignal = registerSignal("priorityInversion");
+simsignal_t CanOutputBuffer::txAbortSignal = registerSignal("txAbort");
+
+CanOutputBuffer::CanOutputBuffer(){
+    canBusLogic = nullptr;
+    portOutput = nullptr;
+    queueDiscipline = nullptr;
+    refillWhenEmpty = false;
+    abortLowerPriority = false;
+    inversionThreshold = -1;
+    busOff = false;
+}
+
 CanOutputBuffer::~CanOutputBuffer(){
-    for (std::list<cMessage*>::iterator it =  frames.begin(); it != frames.end(); ++it)
+    for (IndexedFrameQueue<CanDataFrame, CanFrameKey>::const_iterator it = frames.begin(); it != frames.end(); ++it)
     {
             cancelAndDelete((*it));
     }
     frames.clear();
+    delete queueDiscipline;
+}
+
+void CanOutputBuffer::initialize(int stage) {
+    if (stage == 0) {
+        CanBuffer::initialize();
+        int mailboxCount = par("txMailboxes");
+        if (mailboxCount < 0) {
+            throw cRuntimeError("The number of transmit mailboxes of %s must not be negative.", getFullPath().c_str());
+        }
+        const char *discipline = par("queueDiscipline").stringValue();
+        if (discipline[0] != '\0' || mailboxCount > 0) {
+            queueDiscipline = FrameQueueDiscipline<CanDataFrame, CanFrameKey>::create(
+                    discipline[0] != '\0' ? discipline : "fifo");
+            mailboxes.assign(static_cast<size_t>(mailboxCount > 0 ? mailboxCount : 1), nullptr);
+        }
+        const char *refill = par("mailboxRefill").stringValue();
+        if (strcmp(refill, "immediate") == 0) {
+            refillWhenEmpty = false;
+        } else if (strcmp(refill, "whenEmpty") == 0) {
+            refillWhenEmpty = true;
+        } else {
+            throw cRuntimeError("Unknown mailbox refill policy \"%s\". Use immediate or whenEmpty.", refill);
+        }
+        abortLowerPriority = par("abortLowerPriority");
+    } else if (stage == 1) {
+        cModule *bus = getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule();
+        canBusLogic = resolveModule<CanBusLogic>(bus ? bus->getSubmodule("canBusLogic") : nullptr,
+                "canBusLogic of the connected bus", this);
+        portOutput = resolveModule<CanPortOutput>(
+                getParentModule()->getModuleByPath(".canNodePort.canPortOutput"),
+                "canNodePort.canPortOutput", this);
+    }
 }
 
 void CanOutputBuffer::putFrame(cMessage* msg) {
-    CanDataFrame *frame = dynamic_cast<CanDataFrame *>(msg);
+    CanDataFrame *frame = check_and_cast<CanDataFrame *>(msg);
     if (MOB == true) {
-        if (getFrame(frame->getCanID()) != nullptr) {
-            checkoutFromArbitration(frame->getCanID());
+        CanDataFrame *oldFrame = getFrame(frame->getCanID());
+        if (oldFrame != nullptr) {
+            withdrawFrame(oldFrame);
         }
     }
-    frames.push_back(frame);
-    emit(queueLengthSignal, static_cast<unsigned long>(frames.size()));
-    queueSize+=static_cast<size_t>(frame->getByteLength());
-    emit(queueSizeSignal, static_cast<unsigned long>(queueSize));
-    registerForArbitration(frame->getCanID(), frame->getRtr());
+    if (!admit(frame)) {
+        emit(rxPkSignal, msg);
+        rejectFrame(frame);
+        return;
+    }
+    enqueue(frame);
+    if (queueDiscipline != nullptr) {
+        queueFrame(frame);
+        if (abortLowerPriority) {
+            abortLowerPriorityMailbox();
+        }
+        refillMailboxes();
+    } else if (!busOff) {
+        registerForArbitration(frame);
+    }
     emit(rxPkSignal, msg);
 }
 
-void CanOutputBuffer::registerForArbitration(unsigned int canID, bool rtr) {
-    CanBusLogic *canBusLogic =
-            dynamic_cast<CanBusLogic*> (getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule()->getSubmodule(
-                    "canBusLogic"));
-    canBusLogic->registerForArbitration(canID, this, simTime(), rtr);
+void CanOutputBuffer::putFrameDirect(CanDataFrame *frame) {
+    Enter_Method_Silent
+    ();
+    take(frame);
+    recordPacketReceived(frame);
+    putFrame(frame);
+}
+
+void CanOutputBuffer::withdrawFrame(CanDataFrame *frame) {
+    if (queueDiscipline == nullptr) {
+        checkoutFromArbitration(frame);
+    } else if (queueDiscipline->remove(frame)) {
+        frameDequeued(frame);
+        deleteFrame(frame);
+    } else {
+        for (size_t i = 0; i < mailboxes.size(); i++) {
+            if (mailboxes[i] == frame) {
+                if (checkoutFromArbitration(frame)) {
+                    mailboxes[i] = nullptr;
+                    mailboxesChanged();
+                }
+                break;
+            }
+        }
+    }
+}
+
+bool CanOutputBuffer::dropFrame(CanDataFrame *frame) {
+    if (queueDiscipline != nullptr && queueDiscipline->remove(frame)) {
+        frameDequeued(frame);
+    } else {
+        if (!isWithdrawable(frame)) {
+            return false;
+        }
+        canBusLogic->checkoutFromArbitration(static_cast<CanID*>(frame->getContextPointer()), frame->getId());
+        for (size_t i = 0; i < mailboxes.size(); i++) {
+            if (mailboxes[i] == frame) {
+                mailboxes[i] = nullptr;
+                mailboxesChanged();
+            }
+        }
+    }
+    if (frame == currentFrame) {
+        currentFrame = nullptr;
+    }
+    return CanBuffer::dropFrame(frame);
+}
+
+void CanOutputBuffer::refillMailboxes() {
+    if (refillWhenEmpty) {
+        for (size_t i = 0; i < mailboxes.size(); i++) {
+            if (mailboxes[i] != nullptr) {
+                return;
+            }
+        }
+    }
+    bool changed = false;
+    for (size_t i = 0; i < mailboxes.size() && !queueDiscipline->empty(); i++) {
+        if (mailboxes[i] == nullptr) {
+            CanDataFrame *frame = queueDiscipline->pop();
+            frameDequeued(frame);
+            mailboxes[i] = frame;
+            if (!busOff) {
+                registerForArbitration(frame);
+            }
+            changed = true;
+        }
+    }
+    if (changed) {
+        mailboxesChanged();
+    }
+}
+
+void CanOutputBuffer::abortLowerPriorityMailbox() {
+    CanDataFrame *next = queueDiscipline->front();
+    if (next == nullptr) {
+        return;
+    }
+    size_t lowest = 0;
+    for (size_t i = 0; i < mailboxes.size(); i++) {
+        if (mailboxes[i] == nullptr) {
+            //free mailboxes are filled by the refill policy
+            return;
+        }
+        if (mailboxes[i]->getCanID() > mailboxes[lowest]->getCanID()) {
+            lowest = i;
+        }
+    }
+    CanDataFrame *aborted = mailboxes[lowest];
+    //a frame whose can ID is queued again is not aborted to keep the order of frames with the same can ID
+    if (next->getCanID() >= aborted->getCanID() || queuedIds.count(aborted->getCanID()) != 0
+            || !isWithdrawable(aborted)) {
+        return;
+    }
+    canBusLogic->checkoutFromArbitration(static_cast<CanID*>(aborted->getContextPointer()), aborted->getId());
+    aborted->setContextPointer(nullptr);
+    emit(txAbortSignal, aborted);
+
+    queueDiscipline->pop();
+    frameDequeued(next);
+    mailboxes[lowest] = next;
+    if (!busOff) {
+        registerForArbitration(next);
+    }
+    queueFrame(aborted);
+    mailboxesChanged();
+}
+
+bool CanOutputBuffer::isWithdrawable(CanDataFrame *frame) {
+    return canBusLogic->getCurrentSendingId() != frame->getCanID() && canBusLogic->getSendingNodeID() != this->getId();
+}
+
+simtime_t CanOutputBuffer::deadlineOf(CanDataFrame *frame) {
+    return frame->getTimestamp() + frame->getPeriod();
+}
+
+void CanOutputBuffer::queueFrame(CanDataFrame *frame) {
+    unsigned int canID = frame->getCanID();
+    if (queuedIds[canID]++ == 0 && static_cast<long>(canID) < inversionThreshold) {
+        inversionStart[canID] = simTime();
+    }
+    CanDataFrame *displacedFrame = queueDiscipline->push(frame, deadlineOf(frame));
+    if (displacedFrame != nullptr) {
+        frameDequeued(displacedFrame);
+        deleteFrame(displacedFrame);
+    }
+}
+
+void CanOutputBuffer::frameDequeued(CanDataFrame *frame) {
+    unsigned int canID = frame->getCanID();
+    std::map<unsigned int, unsigned int>::iterator it = queuedIds.find(canID);
+    if (it != queuedIds.end() && --it->second == 0) {
+        queuedIds.erase(it);
+        endInversion(canID);
+    }
+}
+
+void CanOutputBuffer::mailboxesChanged() {
+    long threshold = -1;
+    for (size_t i = 0; i < mailboxes.size(); i++) {
+        if (mailboxes[i] != nullptr && static_cast<long>(mailboxes[i]->getCanID()) > threshold) {
+            threshold = static_cast<long>(mailboxes[i]->getCanID());
+        }
+    }
+    //only the queued can IDs between the old and the new threshold change their state
+    if (threshold > inversionThreshold) {
+        for (std::map<unsigned int, unsigned int>::iterator it = queuedIds.lower_bound(
+                static_cast<unsigned int>(inversionThreshold < 0 ? 0 : inversionThreshold));
+                it != queuedIds.end() && static_cast<long>(it->first) < threshold; ++it) {
+            inversionStart.insert(std::make_pair(it->first, simTime()));
+        }
+    } else if (threshold < inversionThreshold) {
+        for (std::map<unsigned int, unsigned int>::iterator it = queuedIds.lower_bound(
+                static_cast<unsigned int>(threshold < 0 ? 0 : threshold));
+                it != queuedIds.end() && static_cast<long>(it->first) < inversionThreshold; ++it) {
+            endInversion(it->first);
+        }
+    }
+    inversionThreshold = threshold;
+}
+
+void CanOutputBuffer::endInversion(unsigned int canID) {
+    std::unordered_map<unsigned int, simtime_t>::iterator it = inversionStart.find(canID);
+    if (it == inversionStart.end()) {
+        return;
+    }
+    simtime_t duration = simTime() - it->second;
+    inversionStart.erase(it);
+    if (duration > SIMTIME_ZERO) {
+        emit(priorityInversionSignal, duration);
+        emit(getInversionSignal(canID), duration);
+    }
+}
+
+simsignal_t CanOutputBuffer::getInversionSignal(unsigned int canID) {
+    std::unordered_map<unsigned int, simsignal_t>::iterator it = inversionSignals.find(canID);
+    if (it != inversionSignals.end()) {
+        return it->second;
+    }
+    std::string name = "priorityInversion-" + std::to_string(canID);
+    simsignal_t signal = registerSignal(name.c_str());
+    getEnvir()->addResultRecorders(this, signal, name.c_str(),
+            getProperties()->get("statisticTemplate", "priorityInversionPerId"));
+    inversionSignals[canID] = signal;
+    return signal;
+}
+
+void CanOutputBuffer::registerForArbitration(CanDataFrame *frame) {
+    frame->setContextPointer(canBusLogic->registerForArbitration(frame->getCanID(), this, simTime(), frame->getRtr(), frame->getId()));
 }
 
-void CanOutputBuffer::checkoutFromArbitration(unsigned int canID) {
-    CanBusLogic *canBusLogic =
-            dynamic_cast<CanBusLogic*> (getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule()->getSubmodule(
-                    "canBusLogic"));
-    if (canBusLogic->getCurrentSendingId() != canID && canBusLogic->getSendingNodeID() != this->getId()) {
-        canBusLogic->checkoutFromArbitration(canID);
-        deleteFrame(canID);
+bool CanOutputBuffer::checkoutFromArbitration(CanDataFrame *frame) {
+    if (isWithdrawable(frame)) {
+        canBusLogic->checkoutFromArbitration(static_cast<CanID*>(frame->getContextPointer()), frame->getId());
+        deleteFrame(frame);
+        return true;
     }
+    return false;
 }
 
 void CanOutputBuffer::receiveSendingPermission(unsigned int canID) {
@@ -84,12 +328,48 @@ void CanOutputBuffer::receiveSendingPermission(unsigned int canID) {
 void CanOutputBuffer::sendingCompleted() {
     Enter_Method_Silent
     ();
+    for (size_t i = 0; i < mailboxes.size(); i++) {
+        if (mailboxes[i] == currentFrame) {
+            mailboxes[i] = nullptr;
+        }
+    }
     deleteFrame(currentFrame);
     currentFrame = nullptr;
-    CanPortOutput* portOutput = check_and_cast<CanPortOutput*>(
-            getParentModule()->getSubmodule("canNodePort")->getSubmodule(
-                    "canPortOutput"));
+    if (queueDiscipline != nullptr) {
+        mailboxesChanged();
+        refillMailboxes();
+    }
     portOutput->sendingCompleted();
 }
 
+void CanOutputBuffer::enterBusOff() {
+    Enter_Method_Silent
+    ();
+    busOff = true;
+    for (IndexedFrameQueue<CanDataFrame, CanFrameKey>::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+        CanDataFrame *frame = *it;
+        canBusLogic->checkoutFromArbitration(static_cast<CanID*>(frame->getContextPointer()), frame->getId());
+        frame->setContextPointer(nullptr);
+    }
+    //the interrupted frame is transmitted again after the recovery
+    currentFrame = nullptr;
+}
+
+void CanOutputBuffer::leaveBusOff() {
+    Enter_Method_Silent
+    ();
+    busOff = false;
+    if (queueDiscipline != nullptr) {
+        for (size_t i = 0; i < mailboxes.size(); i++) {
+            if (mailboxes[i] != nullptr) {
+                registerForArbitration(mailboxes[i]);
+            }
+        }
+        return;
+    }
+    for (IndexedFrameQueue<CanDataFrame, CanFrameKey>::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+        registerForArbitration(*it);
+    }
+}
+
 }
@@ -32,13 +32,29 @@
 //FiCo4OMNeT
 #include "fico4omnet/base/FiCo4OMNeT_Defs.h"
 
+#include "fico4omnet/buffer/FrameQueueDiscipline.h"
 #include "fico4omnet/buffer/can/CanBuffer.h"
 
+//Std
+#include <map>
+#include <unordered_map>
+#include <vector>
+
 namespace FiCo4OMNeT {
 
+class CanBusLogic;
+class CanPortOutput;
+
 /**
  * @brief This buffer holds messages which will be sent to the bus.
  *
+ * Without a queue discipline all buffered frames take part in the arbitration. With a queue discipline the buffer
+ * models a CAN controller with a limited number of transmit mailboxes: only the frames in the mailboxes are offered
+ * to the bus, the discipline selects the frames that are moved from the software queue into free mailboxes.
+ *
+ * A frame waiting in the software queue while a mailbox holds a frame with a higher can ID suffers priority
+ * inversion. The duration of every inversion episode is emitted per can ID.
+ *
  * @ingroup Buffer
  *
  * @author Stefan Buschmann
@@ -46,6 +62,11 @@ namespace FiCo4OMNeT {
 class CanOutputBuffer: public CanBuffer {
 
 public:
+    /**
+     * @brief Constructor
+     */
+    CanOutputBuffer();
+
     /**
      * @brief Destructor
      */
@@ -63,6 +84,16 @@ public:
      */
     virtual void sendingCompleted();
 
+    /**
+     * @brief Is called when the node becomes bus-off. All frames are withdrawn from the arbitration but kept in the buffer.
+     */
+    virtual void enterBusOff();
+
+    /**
+     * @brief Is called when the node recovered from bus-off. All buffered frames are registered for arbitration again.
+     */
+    virtual void leaveBusOff();
+
     /**
      * @brief Puts the frame into the collection and informs the connected gates about the receiption.
      *
@@ -71,21 +102,187 @@ public:
      */
     virtual void putFrame(cMessage* msg);
 
+    /**
+     * @brief Is called by a source application to put a frame into the buffer without sending it.
+     *
+     * Used when the periodic traffic of the bus is released by a ~CanTrafficDriver.
+     *
+     * @param frame The frame to put in the buffer, the buffer takes the ownership.
+     */
+    virtual void putFrameDirect(CanDataFrame *frame);
+
 protected:
+    /**
+     * @brief Initialization of the module.
+     *
+     * The bus logic and the port output are resolved in the second stage.
+     *
+     * @param stage the initialization stage
+     */
+    virtual void initialize(int stage);
+
+    /**
+     * @brief Number of initialization stages.
+     */
+    virtual int numInitStages() const { return 2; }
+
     /**
      * @brief This method registers a frame at the bus for arbitration.
      *
-     * @param canID The can ID of the frame
-     * @param rtr Identifier whether the frame is a remote frame
+     * The handle returned by the bus is kept in the context pointer of the frame.
+     *
+     * @param frame The frame to register
      */
-    virtual void registerForArbitration(unsigned int canID, bool rtr);
+    virtual void registerForArbitration(CanDataFrame *frame);
 
     /**
-     * @brief Unregister from arbitration at the bus.
+     * @brief Unregister the frame from arbitration at the bus and delete it.
      *
-     * @param canID The can ID of the frame
+     * The frame is kept if it is currently transmitted.
+     *
+     * @param frame The frame to unregister
+     *
+     * @return true if the frame was deleted
+     */
+    virtual bool checkoutFromArbitration(CanDataFrame *frame);
+
+    /**
+     * @brief Drops a buffered frame when the buffer is full.
+     *
+     * The frame is withdrawn from the queue discipline, the mailboxes or the arbitration. Frames are not dropped
+     * while the node or the can ID of the frame is transmitting.
+     *
+     * @param frame The frame to drop
+     *
+     * @return true if the frame was dropped
+     */
+    virtual bool dropFrame(CanDataFrame *frame);
+
+    /**
+     * @brief Removes an older frame with the same can ID, used for the message object buffer (MOB).
+     *
+     * @param frame The frame to remove
+     */
+    virtual void withdrawFrame(CanDataFrame *frame);
+
+    /**
+     * @brief Moves frames from the queue discipline into the free mailboxes according to the refill policy.
+     */
+    virtual void refillMailboxes();
+
+    /**
+     * @brief Aborts the mailbox with the lowest priority if the next queued frame has a higher priority.
+     *
+     * The aborted frame is put back into the software queue and the mailbox is refilled with the queued frame.
+     */
+    virtual void abortLowerPriorityMailbox();
+
+    /**
+     * @brief Checks whether the frame may be withdrawn from the arbitration.
+     *
+     * @param frame The frame
+     *
+     * @return false while the node or the can ID of the frame is transmitting
+     */
+    bool isWithdrawable(CanDataFrame *frame);
+
+private:
+    /**
+     * @brief Bus logic of the bus the node is connected to.
+     */
+    CanBusLogic *canBusLogic;
+
+    /**
+     * @brief Port output of the node.
+     */
+    CanPortOutput *portOutput;
+
+    /**
+     * @brief Queue discipline for the frames that wait for transmission, nullptr if all frames are offered to the bus.
+     */
+    FrameQueueDiscipline<CanDataFrame, CanFrameKey> *queueDiscipline;
+
+    /**
+     * @brief Transmit mailboxes when a queue discipline is used, nullptr marks a free mailbox.
+     */
+    std::vector<CanDataFrame*> mailboxes;
+
+    /**
+     * @brief If true the mailboxes are only refilled after all of them were transmitted.
+     */
+    bool refillWhenEmpty;
+
+    /**
+     * @brief If true a mailbox with a lower priority is aborted in favour of a queued frame with a higher priority.
+     */
+    bool abortLowerPriority;
+
+    /**
+     * @brief Number of queued frames per can ID.
+     */
+    std::map<unsigned int, unsigned int> queuedIds;
+
+    /**
+     * @brief Start of the current priority inversion episode per can ID.
+     */
+    std::unordered_map<unsigned int, simtime_t> inversionStart;
+
+    /**
+     * @brief Highest can ID in the mailboxes, -1 if all mailboxes are free. Queued frames with a lower can ID suffer priority inversion.
+     */
+    long inversionThreshold;
+
+    /**
+     * @brief Signals for the priority inversion time per can ID.
+     */
+    std::unordered_map<unsigned int, simsignal_t> inversionSignals;
+
+    /**
+     * @brief Signal for the priority inversion time of all can IDs.
+     */
+    static simsignal_t priorityInversionSignal;
+
+    /**
+     * @brief Signal for aborted mailbox transmissions.
+     */
+    static simsignal_t txAbortSignal;
+
+    /**
+     * @brief Deadline of a frame for the queue discipline (sign-in time + period).
+     *
+     * The source applications set the timestamp of a frame to its sign-in time.
+     */
+    static simtime_t deadlineOf(CanDataFrame *frame);
+
+    /**
+     * @brief Inserts the frame into the queue discipline.
+     */
+    void queueFrame(CanDataFrame *frame);
+
+    /**
+     * @brief Is called when a frame was removed from the queue discipline.
+     */
+    void frameDequeued(CanDataFrame *frame);
+
+    /**
+     * @brief Recalculates the priority inversion threshold after the content of the mailboxes changed.
+     */
+    void mailboxesChanged();
+
+    /**
+     * @brief Ends the priority inversion episode of the can ID and emits its duration.
+     */
+    void endInversion(unsigned int canID);
+
+    /**
+     * @brief Returns the signal for the priority inversion time of the can ID, the signal is registered on first use.
+     */
+    simsignal_t getInversionSignal(unsigned int canID);
+
+    /**
+     * @brief True while the node is bus-off. Frames are buffered but not registered at the bus.
      */
-    virtual void checkoutFromArbitration(unsigned int canID);
+    bool busOff;
 };
 
 }
@@ -11,6 +11,17 @@
 
 namespace FiCo4OMNeT {
 
+/**
+ * @brief Key of the FlexRay frames in the #FRBuffer.
+ */
+struct FRFrameKey {
+    typedef int Key;
+
+    static Key key(const FRFrame *frame) {
+        return frame->getFrameID();
+    }
+};
+
 /**
  * @brief Represents the content of a physical buffer on a CAN_Node 
  *
@@ -28,7 +39,7 @@ namespace FiCo4OMNeT {
  *
  * @author Stefan Buschmann
  */
-class FRBuffer : public Buffer {
+class FRBuffer : public Buffer<FRFrame, FRFrameKey> {
 
 public:
     /**
@@ -37,41 +48,10 @@ public:
 //    virtual void registerDestinationGate();
 
     /**
-     *
-     * @return A pointer to the DataFrame with the corresponding ID. Returns
-     * null if there is no DataFrame in the buffer.
-     *
-     */
-    FRFrame* getFrame(int frameId);
-
-    /**
-     * @brief Puts the frame into the collection and informs the connected gates about the receiption.
-     *
-     * @param msg The FRFrame to put in the buffer.
-     *
-     */
-    virtual void putFrame(cMessage* msg);
-
-    /**
-     * @brief Deletes the frame with the corresponding id from the frames collection.
-     */
-    virtual void deleteFrame(int frameId);
-
-    /**
-     * @brief Forwards the frame with the corresponding id to all destination gates.
+     * @brief Forwards the frame with the corresponding id to all destination gates and removes it from the buffer.
      */
     virtual void deliverFrame(int frameId);
 
-    /**
-     * @brief Forwards the frame with the highest priority to all destination gates.
-     */
-    virtual void deliverPrioFrame();
-
-    /**
-     * @brief Forwards the first received frame to all destination gates.
-     */
-    virtual void deliverNextFrame();
-
 protected:
     /**
      * @brief Initialization of the module.
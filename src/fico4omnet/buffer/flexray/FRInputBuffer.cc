@@ -20,14 +20,21 @@ namespace FiCo4OMNeT {
 Define_Module(FRInputBuffer);
 
 void FRInputBuffer::putFrame(cMessage* msg) {
-    FRFrame *frame = dynamic_cast<FRFrame*>(msg);
+    FRFrame *frame = check_and_cast<FRFrame*>(msg);
+    bool overwritten = false;
     if (getFrame(frame->getFrameID()) != nullptr) {
         deleteFrame(frame->getFrameID());
-    } else {
+        overwritten = true;
+    }
+    if (!admit(frame)) {
+        rejectFrame(frame);
+        return;
+    }
+    enqueue(frame);
+    if (!overwritten) {
         cModule *frSinkApp = getParentModule()->getSubmodule("frSinkApp");
         sendDirect(new cMessage("Message in buffer"), frSinkApp, "controllerIn");
     }
-    frames.push_back(frame);
 }
 
 }
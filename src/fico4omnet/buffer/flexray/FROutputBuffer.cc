@@ -16,6 +16,7 @@
 #include "fico4omnet/buffer/flexray/FROutputBuffer.h"
 
 #include "fico4omnet/scheduler/flexray/FRScheduler.h"
+#include "fico4omnet/utilities/HelperFunctions.h"
 
 //Auto-generated messages
 #include "fico4omnet/scheduler/flexray/SchedulerMessageEvents_m.h"
@@ -24,15 +25,28 @@ namespace FiCo4OMNeT {
 
 Define_Module(FROutputBuffer);
 
+FROutputBuffer::FROutputBuffer() {
+    frScheduler = nullptr;
+}
+
+void FROutputBuffer::initialize(int stage) {
+    if (stage == 0) {
+        FRBuffer::initialize();
+    } else if (stage == 1) {
+        frScheduler = resolveModule<FRScheduler>(getParentModule()->getSubmodule("frScheduler"), "frScheduler", this);
+    }
+}
+
 void FROutputBuffer::putFrame(cMessage* msg) {
-    FRFrame *frame = dynamic_cast<FRFrame*>(msg);
+    FRFrame *frame = check_and_cast<FRFrame*>(msg);
     if (getFrame(frame->getFrameID()) != nullptr) {
         deleteFrame(frame->getFrameID());
     }
-    frames.push_back(frame);
-    emit(queueLengthSignal, static_cast<unsigned long>(frames.size()));
-    queueSize+=static_cast<size_t>(frame->getByteLength());
-    emit(queueSizeSignal, static_cast<unsigned long>(queueSize));
+    if (admit(frame)) {
+        enqueue(frame);
+    } else {
+        rejectFrame(frame);
+    }
 }
 
 void FROutputBuffer::sendingCompleted(int id) {
@@ -48,11 +62,10 @@ void FROutputBuffer::handleMessage(cMessage *msg) {
         deliverFrame(static_cast<int> (event->getFrameID()));
         delete msg;
     } else {
+        long objectId = msg->getId();
         FRBuffer::handleMessage(msg);
-        if (FRFrame * frame = dynamic_cast<FRFrame*>(msg)) {
-            FRScheduler *frScheduler =
-                    dynamic_cast<FRScheduler*> (getParentModule()->getSubmodule(
-                            "frScheduler"));
+        //frames that were dropped because the buffer is full are not scheduled
+        if (FRFrame * frame = getFrameByObjectId(objectId)) {
             if (frame->getKind() == STATIC_EVENT) {
                 event = new SchedulerActionTimeEvent("Static Event",
                         STATIC_EVENT);
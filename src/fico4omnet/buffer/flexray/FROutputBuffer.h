@@ -22,6 +22,8 @@
 
 namespace FiCo4OMNeT {
 
+class FRScheduler;
+
 /**
  * @brief This buffer holds messages which will be sent to the bus.
  *
@@ -32,6 +34,10 @@ namespace FiCo4OMNeT {
 class FROutputBuffer: public FRBuffer {
 
 public:
+    /**
+     * @brief Constructor
+     */
+    FROutputBuffer();
 
     /**
      * @brief Is called when the frame transmission is completed.
@@ -47,6 +53,20 @@ public:
     virtual void putFrame(cMessage* msg);
 
 protected:
+    /**
+     * @brief Initialization of the module.
+     *
+     * The scheduler is resolved in the second stage.
+     *
+     * @param stage the initialization stage
+     */
+    virtual void initialize(int stage);
+
+    /**
+     * @brief Number of initialization stages.
+     */
+    virtual int numInitStages() const { return 2; }
+
     /**
      * @brief Is called when a new Frame is received in the buffer.
      *
@@ -58,6 +78,12 @@ protected:
      * @param msg The incoming message
      */
     virtual void handleMessage(cMessage *msg);
+
+private:
+    /**
+     * @brief Scheduler of the node.
+     */
+    FRScheduler *frScheduler;
 };
 
 }
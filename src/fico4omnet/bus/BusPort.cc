@@ -43,11 +43,16 @@ void BusPort::handleMessage(cMessage *msg) {
 void BusPort::forward_to_all(cMessage *msg) {
     Enter_Method_Silent();
     take(msg);
-    for (int i = 0; i < this->gateSize("phygate"); ++i) {
+    int numGates = this->gateSize("phygate");
+    if (numGates == 0) {
+        delete msg;
+        return;
+    }
+    for (int i = 0; i < numGates - 1; ++i) {
         cMessage *newMsg = msg->dup();
         send(newMsg, "phygate$o", i);
     }
-    delete msg;
+    send(msg, "phygate$o", numGates - 1);
 }
 
 void BusPort::sendMsgToNode(cMessage *msg, int gateId){
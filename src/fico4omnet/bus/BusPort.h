@@ -59,8 +59,7 @@ class BusPort : public cSimpleModule {
         /**
          * @brief Forwards an Frame to all participants
          *
-         * A copy of the Frame is generated and subsequently sent to all participants.
-         * The original message will be deleted afterwards.
+         * A copy of the Frame is generated for all but the last participant, which receives the original message.
          */
         virtual void forward_to_all(cMessage *msg);
 
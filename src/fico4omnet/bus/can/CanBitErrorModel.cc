@@ -0,0 +1,79 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/bus/can/CanBitErrorModel.h"
+
+//Std
+#include <cmath>
+#include <limits>
+
+namespace FiCo4OMNeT {
+
+CanBitErrorModel::CanBitErrorModel(double setBitErrorRate, cRNG *setRng) :
+        rng(setRng), bitErrorRate(0), logSuccess(0), bitsUntilError(0) {
+    changeBitErrorRate(setBitErrorRate);
+}
+
+CanBitErrorModel::~CanBitErrorModel() {
+}
+
+int64_t CanBitErrorModel::nextErrorPosition(simtime_t start, int64_t frameBits) {
+    if (bitsUntilError >= frameBits) {
+        bitsUntilError -= frameBits;
+        return -1;
+    }
+    int64_t position = bitsUntilError;
+    //the rest of the frame is replaced by the error frame, counting restarts with the next frame
+    bitsUntilError = drawErrorDistance();
+    return position;
+}
+
+void CanBitErrorModel::changeBitErrorRate(double newBitErrorRate) {
+    if (!(newBitErrorRate >= 0 && newBitErrorRate < 1)) {
+        throw cRuntimeError("The bit error rate %g is not permitted. Permitted values are 0 <= rate < 1.",
+                newBitErrorRate);
+    }
+    bitErrorRate = newBitErrorRate;
+    logSuccess = std::log1p(-bitErrorRate);
+    //bit errors are memoryless, so the remaining distance can simply be drawn again
+    bitsUntilError = drawErrorDistance();
+}
+
+int64_t CanBitErrorModel::drawErrorDistance() {
+    const int64_t never = std::numeric_limits<int64_t>::max();
+    if (bitErrorRate <= 0) {
+        return never;
+    }
+    double distance = std::floor(std::log(rng->doubleRandNonz()) / logSuccess);
+    if (distance >= static_cast<double>(never)) {
+        return never;
+    }
+    return static_cast<int64_t>(distance);
+}
+
+}
@@ -0,0 +1,127 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANBITERRORMODEL_H_
+#define FICO4OMNET_CANBITERRORMODEL_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+
+//Std
+#include <cstdint>
+
+namespace FiCo4OMNeT {
+
+using namespace omnetpp;
+
+/**
+ * @brief Bit error model of a CAN bus with independent bit errors at a constant bit error rate.
+ *
+ * Instead of drawing a random number for every frame, the model draws the distance to the next
+ * erroneous bit from a geometric distribution and counts the transmitted bits down. Error-free frames
+ * therefore only cost a subtraction; a random number is only drawn when an error occurs.
+ *
+ * @ingroup Bus
+ */
+class CanBitErrorModel {
+
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param bitErrorRate probability that a single bit is corrupted, must be in [0, 1)
+     * @param rng random number generator used to draw the distances between errors
+     */
+    CanBitErrorModel(double bitErrorRate, cRNG *rng);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~CanBitErrorModel();
+
+    /**
+     * @brief Decides whether and where the next transmitted frame is corrupted.
+     *
+     * Has to be called exactly once for every frame transmitted on the bus.
+     *
+     * @param start time the transmission of the frame starts
+     * @param frameBits length of the frame in bit
+     *
+     * @return position of the first erroneous bit in the frame or -1 if the frame is transmitted without error
+     */
+    virtual int64_t nextErrorPosition(simtime_t start, int64_t frameBits);
+
+    /**
+     * @brief Getter for the bit error rate.
+     *
+     * @return the probability that a single bit is corrupted
+     */
+    double getBitErrorRate() const {
+        return bitErrorRate;
+    }
+
+protected:
+    /**
+     * @brief Changes the bit error rate. The distance to the next error is drawn again with the new rate.
+     *
+     * @param newBitErrorRate probability that a single bit is corrupted, must be in [0, 1)
+     */
+    void changeBitErrorRate(double newBitErrorRate);
+
+    /**
+     * @brief Draws the number of correct bits before the next erroneous bit.
+     *
+     * @return geometrically distributed number of error-free bits
+     */
+    int64_t drawErrorDistance();
+
+    /**
+     * @brief Random number generator of the bus.
+     */
+    cRNG *rng;
+
+private:
+    /**
+     * @brief Probability that a single bit is corrupted.
+     */
+    double bitErrorRate;
+
+    /**
+     * @brief Precomputed log(1 - bitErrorRate) for the inversion of the geometric distribution.
+     */
+    double logSuccess;
+
+    /**
+     * @brief Number of bits that are still transmitted correctly before the next error.
+     */
+    int64_t bitsUntilError;
+};
+
+}
+
+#endif
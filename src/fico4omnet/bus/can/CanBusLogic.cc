@@ -29,6 +29,9 @@
 #include "fico4omnet/bus/can/CanBusLogic.h"
 
 #include "fico4omnet/buffer/can/CanOutputBuffer.h"
+#include "fico4omnet/linklayer/can/CanFrameLength.h"
+#include "fico4omnet/linklayer/can/CanPortInput.h"
+#include "fico4omnet/utilities/HelperFunctions.h"
 
 //Auto-generated messages
 #include "fico4omnet/linklayer/can/messages/ErrorFrame_m.h"
@@ -52,13 +55,22 @@ CanBusLogic::CanBusLogic() {
     numBitsSent = 0;
 
     bandwidth = 0;
+    bitDuration = SIMTIME_ZERO;
+    deliverAtBus = false;
+    bitErrorModel = nullptr;
+    visualize = false;
     currentSendingID = 0;
     sendingNode = nullptr;
+    numPendingIds = 0;
+    recessiveSequences = 0;
+    idleSince = SIMTIME_ZERO;
 }
 CanBusLogic::~CanBusLogic() {
     if(scheduledDataFrame){
         cancelAndDelete(scheduledDataFrame);
     }
+    ids.clear();
+    delete bitErrorModel;
 }
 
 void CanBusLogic::initialize() {
@@ -68,11 +80,33 @@ void CanBusLogic::initialize() {
     rcvdEFSignal = registerSignal("rxEF");
     stateSignal = registerSignal("state");
     arbitrationLengthSignal = registerSignal("arbitrationLength");
+    arbitrationPoolHighWaterMarkSignal = registerSignal("arbitrationPoolHighWaterMark");
 
-    bubble("state: idle");
-    getDisplayString().setTagArg("tt", 0, "state: idle");
+    visualize = isVisualizationEnabled(this);
+    if (visualize) {
+        bubble("state: idle");
+        getDisplayString().setTagArg("tt", 0, "state: idle");
+    }
 
     bandwidth = getParentModule()->par("bandwidth");
+    bitDuration = bitTime(bandwidth);
+
+    double bitErrorRate = getParentModule()->par("bitErrorRate").doubleValue();
+    double goodToBadRate = getParentModule()->par("goodToBadRate").doubleValue();
+    if (goodToBadRate > 0) {
+        bitErrorModel = new CanGilbertElliottModel(bitErrorRate, getParentModule()->par("badBitErrorRate").doubleValue(),
+                goodToBadRate, getParentModule()->par("badToGoodRate").doubleValue(), getRNG(0));
+    } else if (bitErrorRate > 0) {
+        bitErrorModel = new CanBitErrorModel(bitErrorRate, getRNG(0));
+    }
+
+    deliverAtBus = par("deliverAtBus").boolValue();
+    if (deliverAtBus) {
+        resolvePorts();
+    }
+
+    CanVersion version = CanFrameLength::parseVersion(getParentModule()->par("version").stdstringValue());
+    pendingIds = CanIDBitmap(CanFrameLength::idBits(version));
 }
 
 void CanBusLogic::finish() {
@@ -88,7 +122,8 @@ int CanBusLogic::getSendingNodeID() {
 
 void CanBusLogic::handleMessage(cMessage *msg) {
     if (msg->isSelfMessage()) {
-        if (dynamic_cast<CanDataFrame *>(msg)) {
+        if (CanDataFrame *df = dynamic_cast<CanDataFrame *>(msg)) {
+            deliverToReceivers(df);
             sendingCompleted();
         } else if (dynamic_cast<ErrorFrame *>(msg)) {
             colorIdle();
@@ -100,12 +135,15 @@ void CanBusLogic::handleMessage(cMessage *msg) {
             scheduledDataFrame = nullptr;
             errored = false;
             eraseids.clear();
+            receivers.clear();
+            recessiveSequences++;
         }
         grantSendingPermission();
     } else if (dynamic_cast<CanDataFrame *>(msg)) {
         colorBusy();
         emit(stateSignal, static_cast<long>(State::TRANSMITTING));
         handleDataFrame(msg);
+        return;
     } else if (dynamic_cast<ErrorFrame *>(msg)) {
         colorError();
         emit(stateSignal, static_cast<long>(State::TRANSMITTING));
@@ -118,35 +156,30 @@ void CanBusLogic::grantSendingPermission() {
     currentSendingID = INT_MAX;
     sendingNode = nullptr;
 
-    for (std::list<CanID*>::iterator it = ids.begin(); it != ids.end(); ++it) {
-        CanID *id = *it;
-        if (id->getCanID() < currentSendingID) {
-            currentSendingID = id->getCanID();
-            sendingNode = dynamic_cast<CanOutputBuffer*> (id->getNode());
-            currsit = id->getSignInTime();
-        }
-    }
-
     int sendcount = 0;
-    bool nodeFound = false;
-    for (std::list<CanID*>::iterator it = ids.begin(); it != ids.end(); ++it) {
-        CanID *id = *it;
-        if (id->getCanID() == currentSendingID) {
+    if (!pendingIds.empty()) {
+        currentSendingID = pendingIds.first();
+        CanIDList &bucket = ids[currentSendingID];
+        sendingNode = dynamic_cast<CanOutputBuffer*> (bucket.front()->getNode());
+        currsit = bucket.front()->getSignInTime();
+
+        bool nodeFound = false;
+        for (CanID *id = bucket.front(); id != nullptr; id = id->getNext()) {
             if (id->getRtr() == false) { //Data-Frame
                 sendcount++;
                 if (!nodeFound) {
                     nodeFound = true;
                     sendingNode = dynamic_cast<CanOutputBuffer*> (id->getNode());
                     currsit = id->getSignInTime();
-                    eraseids.push_back(it);
+                    eraseids.push_back(id);
                 }
             } else {
-                eraseids.push_back(it);
+                eraseids.push_back(id);
             }
         }
     }
 
-    if (sendcount > 1) {
+    if (sendcount > 1 && visualize) {
         getParentModule()->cComponent::bubble("More than one node sends with the same ID.");
         getParentModule()->getDisplayString().setTagArg("i2", 0, "status/excl3");
         getParentModule()->getDisplayString().setTagArg("tt", 0, "WARNING: More than one node sends with the same ID.");
@@ -157,21 +190,32 @@ void CanBusLogic::grantSendingPermission() {
         controller->receiveSendingPermission(currentSendingID);
     } else {
         idle = true;
-        getDisplayString().setTagArg("tt", 0, "state: idle");
-        bubble("state: idle");
+        idleSince = simTime();
+        if (visualize) {
+            getDisplayString().setTagArg("tt", 0, "state: idle");
+            bubble("state: idle");
+        }
+    }
+}
+
+void CanBusLogic::deliverToReceivers(CanDataFrame *df) {
+    for (std::vector<CanPortInput*>::iterator it = receivers.begin();
+            it != receivers.end(); ++it) {
+        (*it)->completeReception(df);
     }
+    receivers.clear();
 }
 
 void CanBusLogic::sendingCompleted() {
+    recessiveSequences++;
     colorIdle();
     emit(stateSignal, static_cast<long>(State::IDLE));
     CanOutputBuffer* controller = check_and_cast<CanOutputBuffer*>(sendingNode);
     controller->sendingCompleted();
     for (unsigned int it = 0; it != eraseids.size(); it++) {
-        delete *(eraseids.at(it));
-        ids.erase(eraseids.at(it));
+        removeFromArbitration(eraseids.at(it));
     }
-    emit(arbitrationLengthSignal, static_cast<unsigned long>(ids.size()));
+    emit(arbitrationLengthSignal, numPendingIds);
     eraseids.clear();
     errored = false;
     if (scheduledDataFrame != nullptr) {
@@ -182,15 +226,14 @@ void CanBusLogic::sendingCompleted() {
 
 void CanBusLogic::handleDataFrame(cMessage *msg) {
     CanDataFrame *df = check_and_cast<CanDataFrame *>(msg);
-    int64_t length = df->getBitLength();
-    double nextidle;
-    nextidle = static_cast<double> (length) / bandwidth;
+    simtime_t nextidle = bitDuration * df->getBitLength();
     if (scheduledDataFrame != nullptr) {
         cancelEvent(scheduledDataFrame);
     }
     delete (scheduledDataFrame);
     scheduledDataFrame = df->dup();
     scheduleAt(simTime() + nextidle, scheduledDataFrame);
+    receivers.clear();
     emit(rcvdSignal, df);
     if (df->getRtr()) {
         emit(rcvdRFSignal, df);
@@ -199,9 +242,16 @@ void CanBusLogic::handleDataFrame(cMessage *msg) {
         emit(rcvdDFSignal, df);
         numDataFrames++;
     }
-    send(msg->dup(), "gate$o");
     numFramesSent++;
     numBitsSent += static_cast<unsigned long> (df->getBitLength());
+    if (ports.empty()) {
+        send(msg, "gate$o");
+        return;
+    }
+    for (std::vector<CanPortInput*>::iterator it = ports.begin(); it != ports.end(); ++it) {
+        (*it)->startReception(df);
+    }
+    delete msg;
 }
 
 void CanBusLogic::handleErrorFrame(cMessage *msg) {
@@ -211,45 +261,101 @@ void CanBusLogic::handleErrorFrame(cMessage *msg) {
     if (!errored) {
         numErrorFrames++;
         ErrorFrame *ef2 = new ErrorFrame();
-        scheduleAt(simTime() + (MAXERRORFRAMESIZE / (bandwidth)), ef2);
+        scheduleAt(simTime() + bitDuration * MAXERRORFRAMESIZE, ef2);
         emit(rcvdEFSignal, ef2);
         errored = true;
+        receivers.clear();
         send(msg->dup(), "gate$o");
     }
 }
 
-void CanBusLogic::registerForArbitration(unsigned int canID, cModule *module,
-        simtime_t signInTime, bool rtr) {
+void CanBusLogic::resolvePorts() {
+    cModule *bus = getParentModule();
+    for (int gateIndex = 0; gateIndex < bus->gateSize("gate"); gateIndex++) {
+        CanPortInput *port = dynamic_cast<CanPortInput *>(
+                bus->gate("gate$o", gateIndex)->getPathEndGate()->getOwnerModule());
+        if (port == nullptr) {
+            EV << "Gate " << gateIndex << " of the bus does not end at a can port. The frames are sent to the ports.\n";
+            ports.clear();
+            return;
+        }
+        ports.push_back(port);
+    }
+}
+
+unsigned long CanBusLogic::getRecessiveSequences() {
+    if (!idle) {
+        return recessiveSequences;
+    }
+    return recessiveSequences + static_cast<unsigned long>(floor((simTime() - idleSince) / (bitDuration * 11)));
+}
+
+void CanBusLogic::registerReceiver(CanPortInput *port) {
+    receivers.push_back(port);
+}
+
+CanID* CanBusLogic::registerForArbitration(unsigned int canID, cModule *module,
+        simtime_t signInTime, bool rtr, long frameId) {
     Enter_Method_Silent
     ();
-    ids.push_back(new CanID(canID, module, signInTime, rtr));
-    emit(arbitrationLengthSignal, static_cast<unsigned long>(ids.size()));
+    if (canID >> pendingIds.getIdBits() != 0) {
+        throw cRuntimeError("The can ID %u exceeds the identifier range of the bus.", canID);
+    }
+    unsigned long highWaterMark = idPool.getHighWaterMark();
+    CanID *id = idPool.acquire(canID, module, signInTime, rtr, frameId);
+    ids[canID].pushBack(id);
+    pendingIds.set(canID);
+    numPendingIds++;
+    emit(arbitrationLengthSignal, numPendingIds);
+    if (idPool.getHighWaterMark() > highWaterMark) {
+        emit(arbitrationPoolHighWaterMarkSignal, idPool.getHighWaterMark());
+    }
     if (idle) {
+        recessiveSequences = getRecessiveSequences();
         cMessage *self = new cMessage("idle_signin");
-        scheduleAt(simTime() + (1 / (bandwidth)), self);
+        scheduleAt(simTime() + bitDuration, self);
         idle = false;
-        bubble("state: busy");
-        getDisplayString().setTagArg("tt", 0, "state: busy");
+        if (visualize) {
+            bubble("state: busy");
+            getDisplayString().setTagArg("tt", 0, "state: busy");
+        }
         emit(stateSignal, static_cast<long>(State::TRANSMITTING));
     }
+    return id;
 }
 
 void CanBusLogic::checkoutFromArbitration(unsigned int canID) {
     Enter_Method_Silent
     ();
-    for (std::list<CanID*>::iterator it = ids.begin(); it != ids.end(); ++it) {
-        CanID* tmp = *it;
-        if (tmp->getCanID() == canID) {
-            ids.remove(tmp);
-            delete tmp;
-            break;
-        }
+    std::unordered_map<unsigned int, CanIDList>::iterator bucket = ids.find(canID);
+    if (bucket != ids.end() && !bucket->second.empty()) {
+        removeFromArbitration(bucket->second.front());
+    }
+    emit(arbitrationLengthSignal, numPendingIds);
+}
+
+void CanBusLogic::checkoutFromArbitration(CanID *handle, long frameId) {
+    Enter_Method_Silent
+    ();
+    if (handle != nullptr && handle->isPending() && handle->getFrameId() == frameId) {
+        removeFromArbitration(handle);
+    }
+    emit(arbitrationLengthSignal, numPendingIds);
+}
+
+void CanBusLogic::removeFromArbitration(CanID *id) {
+    unsigned int canID = id->getCanID();
+    CanIDList &bucket = ids[canID];
+    bucket.unlink(id);
+    if (bucket.empty()) {
+        pendingIds.clear(canID);
     }
-    emit(arbitrationLengthSignal, static_cast<unsigned long>(ids.size()));
+    idPool.release(id);
+    numPendingIds--;
 }
 
 void CanBusLogic::colorBusy() {
-    if (getEnvir()->isGUI()) {
+    if (visualize) {
         for (int gateIndex = 0;
                 gateIndex
                         < getParentModule()->gate("gate$o", 0)->getVectorSize();
@@ -269,7 +375,7 @@ void CanBusLogic::colorBusy() {
 }
 
 void CanBusLogic::colorIdle() {
-    if (getEnvir()->isGUI()) {
+    if (visualize) {
         for (int gateIndex = 0;
                 gateIndex
                         < getParentModule()->gate("gate$o", 0)->getVectorSize();
@@ -289,7 +395,7 @@ void CanBusLogic::colorIdle() {
 }
 
 void CanBusLogic::colorError() {
-    if (getEnvir()->isGUI()) {
+    if (visualize) {
         for (int gateIndex = 0;
                 gateIndex
                         < getParentModule()->gate("gate$o", 0)->getVectorSize();
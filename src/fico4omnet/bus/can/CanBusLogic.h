@@ -32,13 +32,19 @@
 //FiCo4OMNeT
 #include "fico4omnet/base/FiCo4OMNeT_Defs.h"
 
+#include "fico4omnet/bus/can/CanBitErrorModel.h"
+#include "fico4omnet/bus/can/CanGilbertElliottModel.h"
 #include "fico4omnet/bus/can/CanID.h"
+#include "fico4omnet/bus/can/CanIDBitmap.h"
+#include "fico4omnet/bus/can/CanIDPool.h"
 
 //Auto-generated messages
-#include "fico4omnet/linklayer/can/messages/CanDataFrame_m.h"
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
 
 namespace FiCo4OMNeT {
 
+class CanPortInput;
+
 /**
  * @brief Represents the logic of the bus. It handles the arbitration for the network and provides several statistic values.
  *
@@ -69,9 +75,12 @@ public:
      * @param module the module which wants to send the message
      * @param signInTime the time the frame was signed in
      * @param rtr identifier whether the frame is a remote frame
+     * @param frameId object ID of the registered frame
+     *
+     * @return handle of the registration which can be used for #checkoutFromArbitration(CanID*, long)
      */
-    virtual void registerForArbitration(unsigned int canID, cModule *module,
-            simtime_t signInTime, bool rtr);
+    virtual CanID* registerForArbitration(unsigned int canID, cModule *module,
+            simtime_t signInTime, bool rtr, long frameId = -1);
 
     /**
      * @brief The request for frame with the corresponding ID will be checked out.
@@ -80,6 +89,54 @@ public:
      */
     virtual void checkoutFromArbitration(unsigned int canID);
 
+    /**
+     * @brief The request referenced by the handle will be checked out without searching.
+     *
+     * Handles whose registration was already removed by the bus (e.g. remote frames that were answered
+     * by a data frame with the same ID) are ignored.
+     *
+     * @param handle the handle returned by #registerForArbitration
+     * @param frameId object ID of the frame the handle was registered for
+     */
+    virtual void checkoutFromArbitration(CanID *handle, long frameId);
+
+    /**
+     * @brief Registers a port that accepted the frame currently on the bus.
+     *
+     * Only used if the bus delivers the received frames (#deliverAtBus). The frame is handed to all
+     * registered ports when the transmission is completed. An error frame discards the registrations.
+     *
+     * @param port the port that wants to receive the current frame
+     */
+    virtual void registerReceiver(CanPortInput *port);
+
+    /**
+     * @brief Returns the bit error model of the bus.
+     *
+     * @return the bit error model or nullptr if no bit errors can occur on the bus
+     */
+    CanBitErrorModel* getBitErrorModel() const {
+        return bitErrorModel;
+    }
+
+    /**
+     * @brief Returns the number of sequences of 11 recessive bits observed on the bus so far.
+     *
+     * Used by bus-off nodes to count the sequences they have to observe before they recover.
+     *
+     * @return the number of sequences including the current idle period
+     */
+    virtual unsigned long getRecessiveSequences();
+
+    /**
+     * @brief Returns the maximum number of requests that were pending at the same time.
+     *
+     * @return the high-water mark of the request pool
+     */
+    unsigned long getPoolHighWaterMark() const {
+        return idPool.getHighWaterMark();
+    }
+
     /**
      * @brief getter for #currentSendingID
      *
@@ -168,6 +225,11 @@ private:
      */
     simsignal_t arbitrationLengthSignal;
 
+    /**
+     * @brief Signal for the high-water mark of the request pool. Emitted whenever it rises.
+     */
+    simsignal_t arbitrationPoolHighWaterMarkSignal;
+
     /**
      * The sign-in-time of the current data-frame. Used for forwarding to the node so that they can collect data about the elapsed time.
      *
@@ -192,6 +254,47 @@ private:
      */
     double bandwidth;
 
+    /**
+     * @brief Duration of one bit on the bus. All timings of the bus are integer multiples of it.
+     */
+    simtime_t bitDuration;
+
+    /**
+     * true if the bus schedules the end of the reception for all ports.
+     *
+     * Instead of every port scheduling its own completion event for a received frame, the ports register at
+     * the bus and the completion event of the bus hands the frame to all of them.
+     *
+     */
+    bool deliverAtBus;
+
+    /**
+     * Bit error model shared by all transmissions on the bus. A #CanGilbertElliottModel if burst errors are
+     * configured, nullptr if no bit errors can occur.
+     *
+     */
+    CanBitErrorModel *bitErrorModel;
+
+    /**
+     * true if the state of the bus is visualized in the graphical environment.
+     *
+     */
+    bool visualize;
+
+    /**
+     * Ports that accepted the frame which is currently transmitted. Only used if #deliverAtBus is set.
+     *
+     */
+    std::vector<CanPortInput*> receivers;
+
+    /**
+     * Input ports of all nodes connected to the bus. If #deliverAtBus is set, the start of a data frame is
+     * signalled to these ports by a method call instead of a message per port. Empty if a gate of the bus does
+     * not end at a can port, the frames are sent through the gates in this case.
+     *
+     */
+    std::vector<CanPortInput*> ports;
+
     /**
      * true if bus is in idle state; false if in busy state
      *
@@ -199,15 +302,49 @@ private:
     bool idle;
 
     /**
-     * List of message-IDs that want to send a message. Used like a priority queue.
+     * Message-IDs that want to send a message, indexed by their can ID. Every bucket holds the data and
+     * remote frame requests for one can ID in the order they were signed in. Empty buckets are kept so
+     * that registering an ID that was used before does not allocate.
      *
      */
-    std::list<CanID*> ids;
+    std::unordered_map<unsigned int, CanIDList> ids;
 
     /**
-     * Vector with CanIDs which are currently scheduled for arbitration and will be deleted after transmission.
+     * Pool providing the CanID objects linked into #ids.
+     *
+     */
+    CanIDPool idPool;
+
+    /**
+     * Bitmap of the can IDs with a bucket in #ids. Used like a priority queue: the lowest set bit is the
+     * can ID that wins the arbitration. The size of the bitmap depends on the CAN version of the bus.
+     *
      */
-    std::vector<std::list<CanID*>::iterator> eraseids;
+    CanIDBitmap pendingIds;
+
+    /**
+     * Number of requests over all buckets in #ids.
+     *
+     */
+    unsigned long numPendingIds;
+
+    /**
+     * Number of sequences of 11 recessive bits observed on the bus before the current idle period. Every
+     * completed data or error frame ends with one sequence, an idle bus adds one every 11 bits.
+     *
+     */
+    unsigned long recessiveSequences;
+
+    /**
+     * Simulation time at which the bus became idle.
+     *
+     */
+    simtime_t idleSince;
+
+    /**
+     * Vector with CanIDs of the bucket #currentSendingID which are currently scheduled for arbitration and will be deleted after transmission.
+     */
+    std::vector<CanID*> eraseids;
 
     //statistics:
     /**
@@ -258,14 +395,35 @@ private:
      */
     virtual void grantSendingPermission();
 
+    /**
+     * @brief Hands the completed frame to all registered receivers.
+     *
+     * @param df the frame whose transmission is completed
+     */
+    virtual void deliverToReceivers(CanDataFrame *df);
+
+    /**
+     * @brief Collects the input ports of all nodes connected to the bus.
+     */
+    virtual void resolvePorts();
+
     /**
      * @brief Is called when the transmission of a frame is completed.
      */
     virtual void sendingCompleted();
 
+    /**
+     * @brief Removes the request from its bucket and returns it to the pool.
+     *
+     * @param id the request to remove
+     */
+    void removeFromArbitration(CanID *id);
+
     /**
      * @brief Is called when a data frame is received.
      *
+     * The frame is forwarded to the nodes without copying it, so the ownership is taken.
+     *
      * @param msg received can data frame
      */
     virtual void handleDataFrame(cMessage *msg);
@@ -0,0 +1,78 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/bus/can/CanBusPort.h"
+
+//Std
+#include <algorithm>
+
+//Auto-generated messages
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
+
+namespace FiCo4OMNeT {
+
+Define_Module(CanBusPort);
+
+CanBusPort::CanBusPort() {
+    acceptanceFilter = false;
+}
+
+void CanBusPort::initialize() {
+    acceptanceFilter = par("acceptanceFilter").boolValue();
+}
+
+void CanBusPort::subscribe(unsigned int canID, int gateIndex) {
+    Enter_Method_Silent();
+    std::vector<int> &gates = subscribers[canID];
+    if (std::find(gates.begin(), gates.end(), gateIndex) == gates.end()) {
+        gates.push_back(gateIndex);
+    }
+}
+
+void CanBusPort::forward_to_all(cMessage *msg) {
+    CanDataFrame *df = dynamic_cast<CanDataFrame *>(msg);
+    if (!acceptanceFilter || df == nullptr) {
+        BusPort::forward_to_all(msg);
+        return;
+    }
+    Enter_Method_Silent();
+    take(msg);
+    std::unordered_map<unsigned int, std::vector<int> >::const_iterator it =
+            subscribers.find(df->getCanID());
+    if (it == subscribers.end() || it->second.empty()) {
+        delete msg;
+        return;
+    }
+    const std::vector<int> &gates = it->second;
+    for (size_t i = 0; i + 1 < gates.size(); ++i) {
+        send(msg->dup(), "phygate$o", gates[i]);
+    }
+    send(msg, "phygate$o", gates.back());
+}
+
+}
@@ -0,0 +1,96 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANBUSPORT_H_
+#define FICO4OMNET_CANBUSPORT_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+
+#include "fico4omnet/bus/BusPort.h"
+
+//Std
+#include <unordered_map>
+#include <vector>
+
+namespace FiCo4OMNeT {
+
+/**
+ * @brief Bus port of the CAN bus with an acceptance filter index.
+ *
+ * The ports of the nodes publish the can IDs they send or receive. If the parameter acceptanceFilter
+ * is set, data and remote frames are only forwarded to the nodes that published the can ID of the frame.
+ * Since every transmitter publishes the IDs of its own frames it still receives them. All other messages,
+ * e.g. error frames, are forwarded to all nodes.
+ *
+ * @ingroup Bus
+ */
+class CanBusPort : public BusPort {
+
+    public:
+        /**
+         * @brief Constructor
+         */
+        CanBusPort();
+
+        /**
+         * @brief Forwards a frame to the interested nodes or to all nodes.
+         *
+         * @param msg the frame to forward
+         */
+        virtual void forward_to_all(cMessage *msg);
+
+        /**
+         * @brief Registers the node connected to the gate for frames with the can ID.
+         *
+         * @param canID the can ID the node is interested in
+         * @param gateIndex index of the phygate the node is connected to
+         */
+        virtual void subscribe(unsigned int canID, int gateIndex);
+
+    protected:
+        /**
+         * @brief Reads the parameters.
+         */
+        virtual void initialize();
+
+    private:
+        /**
+         * @brief True if frames are only forwarded to the subscribed nodes.
+         */
+        bool acceptanceFilter;
+
+        /**
+         * @brief Indices of the phygates of the nodes interested in a can ID, indexed by the can ID.
+         */
+        std::unordered_map<unsigned int, std::vector<int> > subscribers;
+};
+
+}
+
+#endif /* FICO4OMNET_CANBUSPORT_H_ */
@@ -0,0 +1,80 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/bus/can/CanGilbertElliottModel.h"
+
+//Std
+#include <cmath>
+
+namespace FiCo4OMNeT {
+
+CanGilbertElliottModel::CanGilbertElliottModel(double setGoodBitErrorRate, double setBadBitErrorRate,
+        double setGoodToBadRate, double setBadToGoodRate, cRNG *setRng) :
+        CanBitErrorModel(setGoodBitErrorRate, setRng), goodBitErrorRate(setGoodBitErrorRate),
+        badBitErrorRate(setBadBitErrorRate), goodToBadRate(setGoodToBadRate), badToGoodRate(setBadToGoodRate),
+        bad(false) {
+    if (!(goodToBadRate > 0 && badToGoodRate > 0)) {
+        throw cRuntimeError("The transition rates of the Gilbert-Elliott model must be greater than 0.");
+    }
+    if (!(badBitErrorRate >= 0 && badBitErrorRate < 1)) {
+        throw cRuntimeError("The bit error rate %g is not permitted. Permitted values are 0 <= rate < 1.",
+                badBitErrorRate);
+    }
+    drawStateEnd(SIMTIME_ZERO);
+}
+
+int64_t CanGilbertElliottModel::nextErrorPosition(simtime_t start, int64_t frameBits) {
+    if (start >= stateEnd) {
+        //the sojourn ended with a transition at stateEnd, the state at the frame start follows from the
+        //transition probabilities of the chain for the time that passed since then
+        bool badAtStateEnd = !bad;
+        double badProbability = goodToBadRate / (goodToBadRate + badToGoodRate);
+        double decay = std::exp(-(goodToBadRate + badToGoodRate) * (start - stateEnd).dbl());
+        double badAtStart = badProbability + ((badAtStateEnd ? 1.0 : 0.0) - badProbability) * decay;
+        bool newBad = rng->doubleRand() < badAtStart;
+        if (newBad != bad) {
+            bad = newBad;
+            changeBitErrorRate(bad ? badBitErrorRate : goodBitErrorRate);
+        }
+        //sojourn times are memoryless, the remaining one starts at the frame start
+        drawStateEnd(start);
+    }
+    return CanBitErrorModel::nextErrorPosition(start, frameBits);
+}
+
+void CanGilbertElliottModel::drawStateEnd(simtime_t from) {
+    double rate = bad ? badToGoodRate : goodToBadRate;
+    double sojourn = -std::log(rng->doubleRandNonz()) / rate;
+    if (sojourn >= (SimTime::getMaxTime() - from).dbl()) {
+        stateEnd = SimTime::getMaxTime();
+    } else {
+        stateEnd = from + sojourn;
+    }
+}
+
+}
@@ -0,0 +1,123 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANGILBERTELLIOTTMODEL_H_
+#define FICO4OMNET_CANGILBERTELLIOTTMODEL_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/bus/can/CanBitErrorModel.h"
+
+namespace FiCo4OMNeT {
+
+/**
+ * @brief Burst error model of a CAN bus with a good and a bad channel state (Gilbert-Elliott).
+ *
+ * The channel alternates between the states with exponentially distributed sojourn times and has a
+ * bit error rate per state. The state is only updated lazily at the start of a frame: if the current
+ * sojourn ended before, the state at the frame start is drawn from the transition probabilities of the
+ * two-state Markov chain. Quiet periods without frames therefore cost nothing, independent of their length.
+ * The state is kept constant for the duration of a frame.
+ *
+ * @ingroup Bus
+ */
+class CanGilbertElliottModel: public CanBitErrorModel {
+
+public:
+    /**
+     * @brief Constructor. The channel starts in the good state.
+     *
+     * @param goodBitErrorRate bit error rate in the good state
+     * @param badBitErrorRate bit error rate in the bad state
+     * @param goodToBadRate rate of the transitions from the good to the bad state in 1/s
+     * @param badToGoodRate rate of the transitions from the bad to the good state in 1/s
+     * @param rng random number generator used for the state transitions and the error distances
+     */
+    CanGilbertElliottModel(double goodBitErrorRate, double badBitErrorRate, double goodToBadRate,
+            double badToGoodRate, cRNG *rng);
+
+    /**
+     * @brief Updates the channel state for the frame start and decides whether and where the frame is corrupted.
+     *
+     * @param start time the transmission of the frame starts
+     * @param frameBits length of the frame in bit
+     *
+     * @return position of the first erroneous bit in the frame or -1 if the frame is transmitted without error
+     */
+    virtual int64_t nextErrorPosition(simtime_t start, int64_t frameBits);
+
+    /**
+     * @brief Returns whether the channel was in the bad state at the start of the last frame.
+     *
+     * @return true if the channel is in the bad state
+     */
+    bool isBad() const {
+        return bad;
+    }
+
+private:
+    /**
+     * @brief Bit error rate in the good state.
+     */
+    double goodBitErrorRate;
+
+    /**
+     * @brief Bit error rate in the bad state.
+     */
+    double badBitErrorRate;
+
+    /**
+     * @brief Rate of the transitions from the good to the bad state in 1/s.
+     */
+    double goodToBadRate;
+
+    /**
+     * @brief Rate of the transitions from the bad to the good state in 1/s.
+     */
+    double badToGoodRate;
+
+    /**
+     * @brief true if the channel is in the bad state.
+     */
+    bool bad;
+
+    /**
+     * @brief Time at which the current sojourn in #bad ends.
+     */
+    simtime_t stateEnd;
+
+    /**
+     * @brief Draws the end of the sojourn in the current state.
+     *
+     * @param from time the sojourn starts
+     */
+    void drawStateEnd(simtime_t from);
+};
+
+}
+
+#endif
@@ -31,7 +31,11 @@
 namespace FiCo4OMNeT {
 
 CanID::CanID(unsigned int setCanID, cModule *setModule, simtime_t setSignInTime, bool setRtr) :
-        canID(setCanID), module(setModule), signInTime(setSignInTime), rtr(setRtr) {
+        canID(setCanID), module(setModule), signInTime(setSignInTime), rtr(setRtr), frameId(-1), pending(false), prev(nullptr), next(nullptr) {
+}
+
+CanID::CanID() :
+        canID(0), module(nullptr), signInTime(SIMTIME_ZERO), rtr(false), frameId(-1), pending(false), prev(nullptr), next(nullptr) {
 }
 
 unsigned int CanID::getCanID() const{
@@ -50,4 +54,16 @@ simtime_t CanID::getSignInTime() const {
     return signInTime;
 }
 
+long CanID::getFrameId() const {
+    return frameId;
+}
+
+bool CanID::isPending() const {
+    return pending;
+}
+
+CanID* CanID::getNext() const {
+    return next;
+}
+
 }
@@ -42,6 +42,9 @@ using namespace omnetpp;
  * This object contains informations about specific message-ID's.
  * The bus can obtain informations about the related node of a message-ID and the configuration of that message-ID. 
  *
+ * The objects are provided by a #CanIDPool and are linked into the per ID buckets of the bus by a #CanIDList,
+ * so a registration can be removed without searching and without heap allocations.
+ *
  * @author Stefan Buschmann
  */
 class CanID {
@@ -59,6 +62,11 @@ class CanID {
 		 */
 		CanID(unsigned int setCanID, cModule *setModule, simtime_t setSignInTime, bool setRtr);
 
+		/**
+	     * @brief Constructor for unused objects of a #CanIDPool
+		 */
+		CanID();
+
 		/**
 	     * @brief Getter for the can ID
 		 *
@@ -91,7 +99,34 @@ class CanID {
 		 */
 		bool getRtr() const;
 
+		/**
+	     * @brief Getter for the object ID of the registered frame
+		 *
+		 * @return the object ID of the frame this registration belongs to, -1 if unknown
+		 *
+		 */
+		long getFrameId() const;
+
+		/**
+	     * @brief Checks whether the object is currently registered for arbitration.
+		 *
+		 * @return true if the object is in use, false if it was returned to its pool
+		 *
+		 */
+		bool isPending() const;
+
+		/**
+	     * @brief Getter for the next registration with the same can ID
+		 *
+		 * @return the next registration in the bucket, nullptr if this is the last one
+		 *
+		 */
+		CanID* getNext() const;
+
 	private:
+		friend class CanIDPool;
+		friend class CanIDList;
+
 		/**
 		* @brief the can ID
 		*/
@@ -111,6 +146,26 @@ class CanID {
 		* @brief identifier whether the frame is a data or remote frame.
 		*/
 		bool rtr;
+
+		/**
+		* @brief Object ID of the registered frame. Used to detect handles that refer to a reused object.
+		*/
+		long frameId;
+
+		/**
+		* @brief true while the object is registered for arbitration
+		*/
+		bool pending;
+
+		/**
+		* @brief Previous registration in the bucket or in the free list of the pool
+		*/
+		CanID *prev;
+
+		/**
+		* @brief Next registration in the bucket or in the free list of the pool
+		*/
+		CanID *next;
 };
 
 }
@@ -0,0 +1,128 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/bus/can/CanIDBitmap.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace FiCo4OMNeT {
+
+CanIDBitmap::CanIDBitmap(unsigned int setIdBits) :
+        idBits(setIdBits) {
+    uint64_t bits = static_cast<uint64_t>(1) << idBits;
+    do {
+        uint32_t words = static_cast<uint32_t>((bits + 63) / 64);
+        Level level;
+        level.isDense = words <= MAXDENSEWORDS;
+        if (level.isDense) {
+            level.dense.assign(words, 0);
+        }
+        levels.push_back(level);
+        bits = words;
+    } while (bits > 1);
+}
+
+void CanIDBitmap::set(unsigned int canID) {
+    uint32_t index = canID;
+    for (std::vector<Level>::iterator level = levels.begin(); level != levels.end(); ++level) {
+        uint64_t &word = level->wordRef(index / 64);
+        bool wasEmpty = (word == 0);
+        word |= static_cast<uint64_t>(1) << (index % 64);
+        if (!wasEmpty) {
+            return;
+        }
+        index /= 64;
+    }
+}
+
+void CanIDBitmap::clear(unsigned int canID) {
+    uint32_t index = canID;
+    for (std::vector<Level>::iterator level = levels.begin(); level != levels.end(); ++level) {
+        if (level->word(index / 64) == 0) {
+            return;
+        }
+        uint64_t &word = level->wordRef(index / 64);
+        word &= ~(static_cast<uint64_t>(1) << (index % 64));
+        if (word != 0) {
+            return;
+        }
+        level->dropWord(index / 64);
+        index /= 64;
+    }
+}
+
+bool CanIDBitmap::test(unsigned int canID) const {
+    return (levels.front().word(canID / 64) >> (canID % 64)) & 1;
+}
+
+bool CanIDBitmap::empty() const {
+    return levels.back().word(0) == 0;
+}
+
+unsigned int CanIDBitmap::first() const {
+    uint32_t index = 0;
+    for (std::vector<Level>::const_reverse_iterator level = levels.rbegin(); level != levels.rend(); ++level) {
+        index = index * 64 + findFirstSet(level->word(index));
+    }
+    return index;
+}
+
+unsigned int CanIDBitmap::findFirstSet(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<unsigned int>(index);
+#else
+    return static_cast<unsigned int>(__builtin_ctzll(word));
+#endif
+}
+
+uint64_t CanIDBitmap::Level::word(uint32_t index) const {
+    if (isDense) {
+        return dense[index];
+    }
+    std::unordered_map<uint32_t, uint64_t>::const_iterator it = sparse.find(index);
+    return it != sparse.end() ? it->second : 0;
+}
+
+uint64_t& CanIDBitmap::Level::wordRef(uint32_t index) {
+    if (isDense) {
+        return dense[index];
+    }
+    return sparse[index];
+}
+
+void CanIDBitmap::Level::dropWord(uint32_t index) {
+    if (!isDense) {
+        sparse.erase(index);
+    }
+}
+
+}
@@ -0,0 +1,152 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANIDBITMAP_H_
+#define FICO4OMNET_CANIDBITMAP_H_
+
+//Std
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace FiCo4OMNeT {
+
+/**
+ * @brief Hierarchical bitmap over the identifier space of a CAN version. Used by the #CanBusLogic to find the pending can ID with the highest priority.
+ *
+ * Every level of the bitmap condenses 64 words of the level below into one word, so the lowest set ID is found with one
+ * find-first-set per level. For 2.0A (11 bit) two dense levels are sufficient. For 2.0B (29 bit) five levels are needed;
+ * the large lower levels are stored sparse so that only words with pending IDs occupy memory.
+ *
+ * @ingroup Bus
+ */
+class CanIDBitmap {
+
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param idBits width of the can identifier in bits (11 for 2.0A, 29 for 2.0B)
+     */
+    explicit CanIDBitmap(unsigned int idBits = 11);
+
+    /**
+     * @brief Marks the can ID as pending.
+     *
+     * @param canID the can ID
+     */
+    void set(unsigned int canID);
+
+    /**
+     * @brief Removes the can ID from the pending IDs.
+     *
+     * @param canID the can ID
+     */
+    void clear(unsigned int canID);
+
+    /**
+     * @brief Checks whether the can ID is pending.
+     *
+     * @param canID the can ID
+     *
+     * @return true if the can ID is pending, false otherwise
+     */
+    bool test(unsigned int canID) const;
+
+    /**
+     * @brief Checks whether any can ID is pending.
+     *
+     * @return true if no can ID is pending, false otherwise
+     */
+    bool empty() const;
+
+    /**
+     * @brief Returns the pending can ID with the highest priority (lowest value). Must not be called on an empty bitmap.
+     *
+     * @return the lowest pending can ID
+     */
+    unsigned int first() const;
+
+    /**
+     * @brief Getter for the width of the identifier space.
+     *
+     * @return the width of the can identifier in bits
+     */
+    unsigned int getIdBits() const {
+        return idBits;
+    }
+
+private:
+    /**
+     * @brief Levels with at most this number of words are stored as dense array.
+     */
+    static const uint32_t MAXDENSEWORDS = 4096;
+
+    /**
+     * @brief One level of the bitmap.
+     */
+    struct Level {
+        /**
+         * @brief true if #dense is used, false if #sparse is used
+         */
+        bool isDense;
+
+        /**
+         * @brief Words of a dense level.
+         */
+        std::vector<uint64_t> dense;
+
+        /**
+         * @brief Non-zero words of a sparse level indexed by word number.
+         */
+        std::unordered_map<uint32_t, uint64_t> sparse;
+
+        uint64_t word(uint32_t index) const;
+        uint64_t& wordRef(uint32_t index);
+        void dropWord(uint32_t index);
+    };
+
+    /**
+     * @brief Width of the can identifier in bits.
+     */
+    unsigned int idBits;
+
+    /**
+     * @brief Levels of the bitmap. Level 0 holds one bit per can ID, the last level consists of a single word.
+     */
+    std::vector<Level> levels;
+
+    /**
+     * @brief Returns the index of the least significant set bit.
+     */
+    static unsigned int findFirstSet(uint64_t word);
+};
+
+}
+
+#endif
@@ -0,0 +1,108 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/bus/can/CanIDPool.h"
+
+namespace FiCo4OMNeT {
+
+CanIDPool::CanIDPool() :
+        freeList(nullptr), inUse(0), highWaterMark(0) {
+}
+
+CanIDPool::~CanIDPool() {
+    for (std::vector<CanID*>::iterator slab = slabs.begin(); slab != slabs.end(); ++slab) {
+        delete[] *slab;
+    }
+    slabs.clear();
+}
+
+CanID* CanIDPool::acquire(unsigned int canID, cModule *module, simtime_t signInTime, bool rtr, long frameId) {
+    if (freeList == nullptr) {
+        CanID *slab = new CanID[SLABSIZE];
+        slabs.push_back(slab);
+        for (unsigned int i = 0; i < SLABSIZE; i++) {
+            slab[i].next = freeList;
+            freeList = &slab[i];
+        }
+    }
+    CanID *id = freeList;
+    freeList = id->next;
+
+    id->canID = canID;
+    id->module = module;
+    id->signInTime = signInTime;
+    id->rtr = rtr;
+    id->frameId = frameId;
+    id->pending = true;
+    id->prev = nullptr;
+    id->next = nullptr;
+
+    inUse++;
+    if (inUse > highWaterMark) {
+        highWaterMark = inUse;
+    }
+    return id;
+}
+
+void CanIDPool::release(CanID *id) {
+    id->pending = false;
+    id->frameId = -1;
+    id->module = nullptr;
+    id->prev = nullptr;
+    id->next = freeList;
+    freeList = id;
+    inUse--;
+}
+
+void CanIDList::pushBack(CanID *id) {
+    id->prev = tail;
+    id->next = nullptr;
+    if (tail != nullptr) {
+        tail->next = id;
+    } else {
+        head = id;
+    }
+    tail = id;
+}
+
+void CanIDList::unlink(CanID *id) {
+    if (id->prev != nullptr) {
+        id->prev->next = id->next;
+    } else {
+        head = id->next;
+    }
+    if (id->next != nullptr) {
+        id->next->prev = id->prev;
+    } else {
+        tail = id->prev;
+    }
+    id->prev = nullptr;
+    id->next = nullptr;
+}
+
+}
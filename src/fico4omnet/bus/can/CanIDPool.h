@@ -0,0 +1,199 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANIDPOOL_H_
+#define FICO4OMNET_CANIDPOOL_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+
+#include "fico4omnet/bus/can/CanID.h"
+
+namespace FiCo4OMNeT {
+
+/**
+ * @brief Slab allocator for the #CanID objects of the #CanBusLogic.
+ *
+ * The objects are allocated in slabs of #SLABSIZE and recycled through a free list, so registering
+ * and completing frames causes no heap traffic once the pool has grown to the maximum number of
+ * concurrently pending frames.
+ *
+ * @ingroup Bus
+ */
+class CanIDPool {
+
+public:
+    /**
+     * @brief Constructor
+     */
+    CanIDPool();
+
+    /**
+     * @brief Destructor. Frees all slabs.
+     */
+    ~CanIDPool();
+
+    /**
+     * @brief Takes an object from the pool and initializes it.
+     *
+     * @param canID the ID of the can frame
+     * @param module the module which wants to send the message
+     * @param signInTime the time the frame was signed in
+     * @param rtr identifier whether the frame is a remote frame
+     * @param frameId object ID of the registered frame
+     *
+     * @return the initialized object
+     */
+    CanID* acquire(unsigned int canID, cModule *module, simtime_t signInTime, bool rtr, long frameId);
+
+    /**
+     * @brief Returns the object to the pool. The object must not be linked in a #CanIDList.
+     *
+     * @param id the object to return
+     */
+    void release(CanID *id);
+
+    /**
+     * @brief Getter for the number of objects currently in use.
+     *
+     * @return number of objects in use
+     */
+    unsigned long getInUse() const {
+        return inUse;
+    }
+
+    /**
+     * @brief Getter for the maximum number of objects that were in use at the same time.
+     *
+     * @return the high-water mark of the pool
+     */
+    unsigned long getHighWaterMark() const {
+        return highWaterMark;
+    }
+
+    /**
+     * @brief Getter for the number of allocated objects.
+     *
+     * @return the capacity of the pool
+     */
+    unsigned long getCapacity() const {
+        return static_cast<unsigned long>(slabs.size()) * SLABSIZE;
+    }
+
+private:
+    /**
+     * @brief Number of objects allocated at once when the pool runs empty.
+     */
+    static const unsigned int SLABSIZE = 64;
+
+    /**
+     * @brief Allocated slabs.
+     */
+    std::vector<CanID*> slabs;
+
+    /**
+     * @brief First unused object.
+     */
+    CanID *freeList;
+
+    /**
+     * @brief Number of objects in use.
+     */
+    unsigned long inUse;
+
+    /**
+     * @brief Maximum of #inUse.
+     */
+    unsigned long highWaterMark;
+
+    CanIDPool(const CanIDPool&);
+    CanIDPool& operator=(const CanIDPool&);
+};
+
+/**
+ * @brief Intrusive doubly linked list of #CanID objects that keeps the registrations in sign-in order.
+ *
+ * @ingroup Bus
+ */
+class CanIDList {
+
+public:
+    /**
+     * @brief Constructor
+     */
+    CanIDList() :
+            head(nullptr), tail(nullptr) {
+    }
+
+    /**
+     * @brief Appends the object at the end of the list.
+     *
+     * @param id the object to append
+     */
+    void pushBack(CanID *id);
+
+    /**
+     * @brief Removes the object from the list.
+     *
+     * @param id the object to remove
+     */
+    void unlink(CanID *id);
+
+    /**
+     * @brief Returns the first object of the list.
+     *
+     * @return the first object, nullptr if the list is empty
+     */
+    CanID* front() const {
+        return head;
+    }
+
+    /**
+     * @brief Checks whether the list is empty.
+     *
+     * @return true if the list is empty, false otherwise
+     */
+    bool empty() const {
+        return head == nullptr;
+    }
+
+private:
+    /**
+     * @brief First object of the list.
+     */
+    CanID *head;
+
+    /**
+     * @brief Last object of the list.
+     */
+    CanID *tail;
+};
+
+}
+
+#endif
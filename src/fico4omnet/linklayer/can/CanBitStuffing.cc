@@ -0,0 +1,168 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/linklayer/can/CanBitStuffing.h"
+
+namespace FiCo4OMNeT {
+
+namespace {
+
+/**
+ * @brief Lookup table of the CRC-15 for one byte.
+ */
+struct Crc15Table {
+    uint16_t entries[256];
+
+    Crc15Table() {
+        for (unsigned int i = 0; i < 256; i++) {
+            unsigned int crc = i << 7;
+            for (int bit = 0; bit < 8; bit++) {
+                crc <<= 1;
+                if (crc & 0x8000) {
+                    crc ^= 0x4599;
+                }
+            }
+            entries[i] = static_cast<uint16_t>(crc & 0x7FFF);
+        }
+    }
+};
+
+const Crc15Table crc15Table;
+
+/**
+ * @brief Writes a bit sequence most significant bit first.
+ */
+class BitWriter {
+public:
+    explicit BitWriter(uint8_t *setBuffer, unsigned int setPosition = 0) :
+            buffer(setBuffer), position(setPosition) {
+    }
+
+    void write(uint32_t value, unsigned int numBits) {
+        for (unsigned int i = numBits; i > 0; i--) {
+            if ((value >> (i - 1)) & 1) {
+                buffer[position / 8] = static_cast<uint8_t>(buffer[position / 8] | (0x80 >> (position % 8)));
+            }
+            position++;
+        }
+    }
+
+    unsigned int getPosition() const {
+        return position;
+    }
+
+private:
+    uint8_t *buffer;
+    unsigned int position;
+};
+
+inline unsigned int bitAt(const uint8_t *buffer, unsigned int position) {
+    return (buffer[position / 8] >> (7 - position % 8)) & 1;
+}
+
+}
+
+size_t CanBitStuffing::writeSequence(unsigned int canID, bool extended, bool rtr, unsigned int dlc,
+        const uint8_t *data, uint8_t *buffer, unsigned int &padding) {
+    if (dlc > MAXDATABYTES) {
+        throw cRuntimeError("The data length code %u is not permitted. Permitted values are 0 to %u.", dlc,
+                MAXDATABYTES);
+    }
+    unsigned int dataBytes = rtr ? 0 : dlc;
+    //SOF, identifier, RTR, IDE, r0 and DLC (2.0A); SOF, base identifier, SRR, IDE, identifier extension, RTR, r1, r0 and DLC (2.0B)
+    unsigned int numBits = (extended ? 39 : 19) + 8 * dataBytes;
+    //leading zeros do not change the CRC, they align the sequence to whole bytes
+    padding = (8 - numBits % 8) % 8;
+
+    BitWriter writer(buffer);
+    writer.write(0, padding);
+    writer.write(0, 1); //SOF
+    if (extended) {
+        writer.write(canID >> 18, 11);
+        writer.write(1, 1); //SRR
+        writer.write(1, 1); //IDE
+        writer.write(canID & 0x3FFFF, 18);
+        writer.write(rtr ? 1 : 0, 1);
+        writer.write(0, 2); //r1, r0
+    } else {
+        writer.write(canID, 11);
+        writer.write(rtr ? 1 : 0, 1);
+        writer.write(0, 2); //IDE, r0
+    }
+    writer.write(dlc, 4);
+    for (unsigned int i = 0; i < dataBytes; i++) {
+        writer.write(data[i], 8);
+    }
+    return writer.getPosition() / 8;
+}
+
+uint16_t CanBitStuffing::frameCrc(unsigned int canID, bool extended, bool rtr, unsigned int dlc,
+        const uint8_t *data) {
+    uint8_t buffer[16] = { 0 };
+    unsigned int padding = 0;
+    return crc15(buffer, writeSequence(canID, extended, rtr, dlc, data, buffer, padding));
+}
+
+unsigned int CanBitStuffing::countStuffBits(unsigned int canID, bool extended, bool rtr, unsigned int dlc,
+        const uint8_t *data) {
+    uint8_t buffer[16] = { 0 };
+    unsigned int padding = 0;
+    size_t numBytes = writeSequence(canID, extended, rtr, dlc, data, buffer, padding);
+    BitWriter writer(buffer, 8 * static_cast<unsigned int>(numBytes));
+    writer.write(crc15(buffer, numBytes), 15);
+
+    unsigned int stuffed = 0;
+    unsigned int run = 0;
+    unsigned int previous = 2;
+    for (unsigned int position = padding; position < writer.getPosition(); position++) {
+        unsigned int bit = bitAt(buffer, position);
+        if (bit == previous) {
+            run++;
+        } else {
+            previous = bit;
+            run = 1;
+        }
+        if (run == 5) {
+            //the stuff bit has the opposite value and starts a new run
+            stuffed++;
+            previous = 1 - bit;
+            run = 1;
+        }
+    }
+    return stuffed;
+}
+
+uint16_t CanBitStuffing::crc15(const uint8_t *bytes, size_t numBytes) {
+    unsigned int crc = 0;
+    for (size_t i = 0; i < numBytes; i++) {
+        crc = ((crc << 8) ^ crc15Table.entries[((crc >> 7) ^ bytes[i]) & 0xFF]) & 0x7FFF;
+    }
+    return static_cast<uint16_t>(crc);
+}
+
+}
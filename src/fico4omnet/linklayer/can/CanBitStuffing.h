@@ -0,0 +1,118 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANBITSTUFFING_H_
+#define FICO4OMNET_CANBITSTUFFING_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+
+//Std
+#include <cstddef>
+#include <cstdint>
+
+namespace FiCo4OMNeT {
+
+using namespace omnetpp;
+
+/**
+ * @brief Exact calculation of the stuff bits of a CAN frame.
+ *
+ * The bit sequence subject to bit stuffing (start of frame, arbitration field, control field, data field and
+ * CRC sequence) is built from the identifier and the payload bytes. The CRC-15 is computed with a byte-wise
+ * lookup table. The source apps calculate the stuff bits once per frame prototype, so no results are cached.
+ *
+ * @ingroup Port
+ */
+class CanBitStuffing {
+
+public:
+    /**
+     * @brief Maximum number of payload bytes of a CAN 2.0 frame.
+     */
+    static const unsigned int MAXDATABYTES = 8;
+
+    /**
+     * @brief Calculates the number of stuff bits of the frame.
+     *
+     * @param canID the can ID of the frame
+     * @param extended true for a 29 bit identifier (2.0B), false for an 11 bit identifier (2.0A)
+     * @param rtr true for a remote frame, which has no data field
+     * @param dlc the data length code (0 to 8)
+     * @param data the payload bytes, at least dlc bytes for data frames, may be nullptr for remote frames
+     *
+     * @return the number of stuff bits
+     */
+    static unsigned int countStuffBits(unsigned int canID, bool extended, bool rtr, unsigned int dlc,
+            const uint8_t *data);
+
+    /**
+     * @brief Calculates the CRC sequence of the frame.
+     *
+     * @param canID the can ID of the frame
+     * @param extended true for a 29 bit identifier (2.0B), false for an 11 bit identifier (2.0A)
+     * @param rtr true for a remote frame, which has no data field
+     * @param dlc the data length code (0 to 8)
+     * @param data the payload bytes, at least dlc bytes for data frames, may be nullptr for remote frames
+     *
+     * @return the 15 bit CRC
+     */
+    static uint16_t frameCrc(unsigned int canID, bool extended, bool rtr, unsigned int dlc, const uint8_t *data);
+
+    /**
+     * @brief Computes the CAN CRC-15 (polynomial 0x4599) of a bit sequence.
+     *
+     * @param bytes the bit sequence, most significant bit first
+     * @param numBytes the number of bytes. Leading zero bits do not change the CRC, so sequences that are not
+     *        byte aligned can be padded with zeros at the front.
+     *
+     * @return the 15 bit CRC
+     */
+    static uint16_t crc15(const uint8_t *bytes, size_t numBytes);
+
+private:
+    /**
+     * @brief Writes the bit sequence of the frame up to the CRC sequence, zero-padded at the front to whole bytes.
+     *
+     * @param canID the can ID of the frame
+     * @param extended true for a 29 bit identifier (2.0B), false for an 11 bit identifier (2.0A)
+     * @param rtr true for a remote frame, which has no data field
+     * @param dlc the data length code (0 to 8)
+     * @param data the payload bytes, at least dlc bytes for data frames, may be nullptr for remote frames
+     * @param buffer zero-initialized buffer of 16 bytes for the sequence
+     * @param padding returns the number of padding bits
+     *
+     * @return the number of bytes written
+     */
+    static size_t writeSequence(unsigned int canID, bool extended, bool rtr, unsigned int dlc,
+            const uint8_t *data, uint8_t *buffer, unsigned int &padding);
+};
+
+}
+
+#endif
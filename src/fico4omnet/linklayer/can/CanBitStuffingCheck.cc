@@ -0,0 +1,90 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/linklayer/can/CanBitStuffingCheck.h"
+
+#include "fico4omnet/linklayer/can/CanBitStuffing.h"
+
+//Std
+#include <cstdlib>
+#include <vector>
+
+namespace FiCo4OMNeT {
+
+Define_Module(CanBitStuffingCheck);
+
+void CanBitStuffingCheck::initialize() {
+    cStringTokenizer referenceTokenizer(par("referenceFrames"), ";");
+    unsigned int numFrames = 0;
+    while (referenceTokenizer.hasMoreTokens()) {
+        checkFrame(referenceTokenizer.nextToken());
+        numFrames++;
+    }
+    EV << numFrames << " reference frames checked.\n";
+}
+
+void CanBitStuffingCheck::handleMessage(cMessage *msg) {
+    delete msg;
+    throw cRuntimeError("CanBitStuffingCheck does not receive messages.");
+}
+
+void CanBitStuffingCheck::checkFrame(const std::string &reference) {
+    std::vector<std::string> fields = cStringTokenizer(reference.c_str(), " ").asVector();
+    if (fields.size() != 7) {
+        throw cRuntimeError("The reference frame \"%s\" is not permitted. Permitted is \"canID extended rtr dlc payload crc stuffBits\".",
+                reference.c_str());
+    }
+    unsigned int canID = static_cast<unsigned int>(strtoul(fields[0].c_str(), nullptr, 0));
+    bool extended = fields[1] == "1";
+    bool rtr = fields[2] == "1";
+    unsigned int dlc = static_cast<unsigned int>(strtoul(fields[3].c_str(), nullptr, 0));
+    uint8_t data[CanBitStuffing::MAXDATABYTES] = { 0 };
+    if (fields[4] != "-") {
+        if (fields[4].size() % 2 != 0 || fields[4].size() / 2 > CanBitStuffing::MAXDATABYTES) {
+            throw cRuntimeError("The payload \"%s\" of a reference frame is not permitted.", fields[4].c_str());
+        }
+        for (size_t i = 0; i < fields[4].size() / 2; i++) {
+            data[i] = static_cast<uint8_t>(strtoul(fields[4].substr(2 * i, 2).c_str(), nullptr, 16));
+        }
+    }
+    unsigned int crc = static_cast<unsigned int>(strtoul(fields[5].c_str(), nullptr, 0));
+    unsigned int stuffBits = static_cast<unsigned int>(strtoul(fields[6].c_str(), nullptr, 0));
+
+    unsigned int calculatedCrc = CanBitStuffing::frameCrc(canID, extended, rtr, dlc, data);
+    if (calculatedCrc != crc) {
+        throw cRuntimeError("Reference frame \"%s\": calculated CRC 0x%04X differs from 0x%04X.", reference.c_str(),
+                calculatedCrc, crc);
+    }
+    unsigned int calculatedStuffBits = CanBitStuffing::countStuffBits(canID, extended, rtr, dlc, data);
+    if (calculatedStuffBits != stuffBits) {
+        throw cRuntimeError("Reference frame \"%s\": calculated %u stuff bits instead of %u.", reference.c_str(),
+                calculatedStuffBits, stuffBits);
+    }
+}
+
+}
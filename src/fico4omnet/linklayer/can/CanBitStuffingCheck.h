@@ -0,0 +1,76 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANBITSTUFFINGCHECK_H_
+#define FICO4OMNET_CANBITSTUFFINGCHECK_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+
+//Std
+#include <string>
+
+namespace FiCo4OMNeT {
+
+using namespace omnetpp;
+
+/**
+ * @brief Checks the exact bit stuffing of #CanBitStuffing against reference frames.
+ *
+ * The CRC and the number of stuff bits of every reference frame are calculated at initialization. The simulation
+ * stops with an error if one of them differs from the reference.
+ *
+ * @ingroup Port
+ */
+class CanBitStuffingCheck : public cSimpleModule {
+
+protected:
+    /**
+     * @brief Checks all reference frames.
+     */
+    virtual void initialize();
+
+    /**
+     * @brief The module does not receive messages.
+     *
+     * @param msg the message
+     */
+    virtual void handleMessage(cMessage *msg);
+
+private:
+    /**
+     * @brief Checks one reference frame.
+     *
+     * @param reference the frame as "canID extended rtr dlc payload crc stuffBits"
+     */
+    void checkFrame(const std::string &reference);
+};
+
+}
+
+#endif
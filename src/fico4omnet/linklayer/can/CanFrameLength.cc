@@ -0,0 +1,82 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/linklayer/can/CanFrameLength.h"
+
+namespace FiCo4OMNeT {
+
+namespace {
+
+template<unsigned int... DataLengths>
+struct DataLengthSequence {
+};
+
+template<unsigned int N, unsigned int... DataLengths>
+struct MakeDataLengthSequence: MakeDataLengthSequence<N - 1, N - 1, DataLengths...> {
+};
+
+template<unsigned int... DataLengths>
+struct MakeDataLengthSequence<0, DataLengths...> {
+    typedef DataLengthSequence<DataLengths...> type;
+};
+
+template<unsigned int... DataLengths>
+constexpr CanFrameLength::Table makeTable(DataLengthSequence<DataLengths...>) {
+    return CanFrameLength::Table { { {
+            { CanFrameLength::calculate(CanVersion::V2_0A, DataLengths, CanStuffing::NONE)... },
+            { CanFrameLength::calculate(CanVersion::V2_0A, DataLengths, CanStuffing::WORST_CASE)... } }, {
+            { CanFrameLength::calculate(CanVersion::V2_0B, DataLengths, CanStuffing::NONE)... },
+            { CanFrameLength::calculate(CanVersion::V2_0B, DataLengths, CanStuffing::WORST_CASE)... } } } };
+}
+
+constexpr CanFrameLength::Table GENERATEDTABLE = makeTable(
+        MakeDataLengthSequence<CanFrameLength::MAXDATALENGTH + 1>::type());
+
+static_assert(GENERATEDTABLE.lengths[0][0][0] == 47, "Length of an empty 2.0A frame without stuff bits");
+static_assert(GENERATEDTABLE.lengths[0][1][8] == 47 + 24, "Length of a full 2.0A frame with worst case stuffing");
+static_assert(GENERATEDTABLE.lengths[1][1][8] == 67 + 29, "Length of a full 2.0B frame with worst case stuffing");
+
+}
+
+constexpr unsigned int CanFrameLength::MAXDATALENGTH;
+constexpr unsigned int CanFrameLength::DATAFRAMECONTROLBITS;
+constexpr unsigned int CanFrameLength::CONTROLBITSFORBITSTUFFING;
+
+const CanFrameLength::Table CanFrameLength::TABLE = GENERATEDTABLE;
+
+CanVersion CanFrameLength::parseVersion(const std::string &version) {
+    if (version.compare("2.0A") == 0) {
+        return CanVersion::V2_0A;
+    } else if (version.compare("2.0B") == 0) {
+        return CanVersion::V2_0B;
+    }
+    throw omnetpp::cRuntimeError(
+            "The value for the parameter \"version\" is not permitted. Permitted values are \"2.0B\" and \"2.0A\".");
+}
+
+}
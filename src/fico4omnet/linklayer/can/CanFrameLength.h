@@ -0,0 +1,208 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANFRAMELENGTH_H_
+#define FICO4OMNET_CANFRAMELENGTH_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+
+//Std
+#include <string>
+
+namespace FiCo4OMNeT {
+
+/**
+ * @brief Versions of the CAN protocol.
+ */
+enum class CanVersion : unsigned int {
+    V2_0A = 0, //!< 11 bit identifier
+    V2_0B = 1  //!< 29 bit identifier
+};
+
+/**
+ * @brief Bit stuffing assumed for the length tables.
+ */
+enum class CanStuffing : unsigned int {
+    NONE = 0,      //!< no stuff bits
+    WORST_CASE = 1 //!< maximum number of stuff bits
+};
+
+/**
+ * @brief Properties of the frame format of a CAN version.
+ */
+template<CanVersion Version>
+struct CanFrameFormat;
+
+/**
+ * @brief Frame format of CAN 2.0A.
+ */
+template<>
+struct CanFrameFormat<CanVersion::V2_0A> {
+    /**
+     * @brief Width of the identifier.
+     */
+    static constexpr unsigned int IDBITS = 11;
+
+    /**
+     * @brief Additional bits of the arbitration field compared to 2.0A.
+     */
+    static constexpr unsigned int ARBITRATIONEXTENSIONBITS = 0;
+};
+
+/**
+ * @brief Frame format of CAN 2.0B.
+ */
+template<>
+struct CanFrameFormat<CanVersion::V2_0B> {
+    /**
+     * @brief Width of the identifier.
+     */
+    static constexpr unsigned int IDBITS = 29;
+
+    /**
+     * @brief Additional bits of the arbitration field compared to 2.0A (SRR, IDE, 18 bit identifier extension).
+     */
+    static constexpr unsigned int ARBITRATIONEXTENSIONBITS = 20;
+};
+
+/**
+ * @brief Frame lengths of CAN data and remote frames.
+ *
+ * The lengths are calculated at compile time for every version, data length code and bit stuffing assumption
+ * and stored in a table, so the length of a frame is a single array access. Like the length of a frame without
+ * payload they do not include the bits of the data field itself.
+ *
+ * @ingroup Port
+ */
+class CanFrameLength {
+
+public:
+    /**
+     * @brief Maximum data length of a CAN 2.0 frame in bytes.
+     */
+    static constexpr unsigned int MAXDATALENGTH = 8;
+
+    /**
+     * @brief Overhead for a data frame with an 11 bit identifier.
+     *
+     * Includes start of frame, arbitration field (11 Bit), remote transmission bit, identifier extension bit,
+     * reserved bit, data length code, CRC, CRC-delimiter, ACK-slot, ACK-delimiter, end of frame and inter frame space.
+     */
+    static constexpr unsigned int DATAFRAMECONTROLBITS = 47;
+
+    /**
+     * @brief Number of control bits which are subject to bit stuffing. Just 34 of the 47 are subject to bit stuffing.
+     */
+    static constexpr unsigned int CONTROLBITSFORBITSTUFFING = 34;
+
+    /**
+     * @brief Returns the number of bits added by the arbitration field of the version.
+     *
+     * @param version the CAN version
+     * @return the additional bits compared to 2.0A
+     */
+    static constexpr unsigned int arbitrationExtensionBits(CanVersion version) {
+        return version == CanVersion::V2_0B ?
+                CanFrameFormat<CanVersion::V2_0B>::ARBITRATIONEXTENSIONBITS :
+                CanFrameFormat<CanVersion::V2_0A>::ARBITRATIONEXTENSIONBITS;
+    }
+
+    /**
+     * @brief Returns the width of the identifier of the version.
+     *
+     * @param version the CAN version
+     * @return the width of the identifier in bits
+     */
+    static constexpr unsigned int idBits(CanVersion version) {
+        return version == CanVersion::V2_0B ?
+                CanFrameFormat<CanVersion::V2_0B>::IDBITS : CanFrameFormat<CanVersion::V2_0A>::IDBITS;
+    }
+
+    /**
+     * @brief Returns the maximum number of stuff bits of a frame.
+     *
+     * @param version the CAN version
+     * @param dataLength size of the data field in bytes
+     * @return the number of stuff bits in the worst case
+     */
+    static constexpr unsigned int worstCaseStuffBits(CanVersion version, unsigned int dataLength) {
+        return (CONTROLBITSFORBITSTUFFING + arbitrationExtensionBits(version) + dataLength * 8 - 1) / 4;
+    }
+
+    /**
+     * @brief Calculates the length of a frame without the data field.
+     *
+     * @param version the CAN version
+     * @param dataLength size of the data field in bytes
+     * @param stuffing the bit stuffing assumption
+     * @return the length in bits
+     */
+    static constexpr unsigned int calculate(CanVersion version, unsigned int dataLength, CanStuffing stuffing) {
+        return DATAFRAMECONTROLBITS + arbitrationExtensionBits(version)
+                + (stuffing == CanStuffing::WORST_CASE ? worstCaseStuffBits(version, dataLength) : 0);
+    }
+
+    /**
+     * @brief Returns the precalculated length of a frame without the data field.
+     *
+     * @param version the CAN version
+     * @param dataLength size of the data field in bytes, at most #MAXDATALENGTH
+     * @param stuffing the bit stuffing assumption
+     * @return the length in bits
+     */
+    static unsigned int lookup(CanVersion version, unsigned int dataLength, CanStuffing stuffing) {
+        return TABLE.lengths[static_cast<unsigned int>(version)][static_cast<unsigned int>(stuffing)][dataLength];
+    }
+
+    /**
+     * @brief Converts the value of a version parameter.
+     *
+     * @param version "2.0A" or "2.0B"
+     * @return the CAN version
+     * @throws cRuntimeError if the value is not permitted
+     */
+    static CanVersion parseVersion(const std::string &version);
+
+    /**
+     * @brief Lengths of all versions, stuffing assumptions and data lengths.
+     */
+    struct Table {
+        unsigned int lengths[2][2][MAXDATALENGTH + 1];
+    };
+
+private:
+    /**
+     * @brief Table generated at compile time.
+     */
+    static const Table TABLE;
+};
+
+}
+
+#endif
@@ -30,6 +30,9 @@
 
 #include "fico4omnet/linklayer/can/CanPortOutput.h"
 #include "fico4omnet/buffer/can/CanOutputBuffer.h"
+#include "fico4omnet/bus/can/CanBusLogic.h"
+#include "fico4omnet/bus/can/CanBusPort.h"
+#include "fico4omnet/utilities/HelperFunctions.h"
 
 namespace FiCo4OMNeT {
 
@@ -37,24 +40,47 @@ Define_Module(CanPortInput);
 
 CanPortInput::CanPortInput(){
     this->bandwidth = 0;
+    this->bitDuration = SIMTIME_ZERO;
     this->errorperc = 0;
+    this->busPort = nullptr;
+    this->busPortGateIndex = -1;
+    this->busLogic = nullptr;
+    this->outputBuffer = nullptr;
+    this->portOutput = nullptr;
     this->scheduledDataFrame = nullptr;
     this->scheduledErrorFrame = nullptr;
+    this->receiving = false;
+    this->errorFlagged = false;
+    this->discardReception = false;
 }
 
-void CanPortInput::initialize() {
-    bandwidth =
-            getParentModule()->getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule()->par(
-                    "bandwidth");
-    errorperc = getParentModule()->getParentModule()->par("errorperc");
+void CanPortInput::initialize(int stage) {
+    if (stage == 0) {
+        bandwidth =
+                getParentModule()->getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule()->par(
+                        "bandwidth");
+        bitDuration = bitTime(bandwidth);
+        errorperc = getParentModule()->getParentModule()->par("errorperc");
 
 
 
-    rcvdDFSignal = registerSignal("rxDF");
-    rcvdRFSignal = registerSignal("rxRF");
-    receivedDFPayload = registerSignal("rxDFPayload");
-    receivedRFPayload = registerSignal("rxRFPayload");
-    WATCH_MAP(incomingDataFrameIDs);
+        rcvdDFSignal = registerSignal("rxDF");
+        rcvdRFSignal = registerSignal("rxRF");
+        receivedDFPayload = registerSignal("rxDFPayload");
+        receivedRFPayload = registerSignal("rxRFPayload");
+        WATCH_MAP(incomingDataFrameIDs);
+    } else if (stage == 1) {
+        cModule *bus = getParentModule()->getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule();
+        CanBusLogic *logic = resolveModule<CanBusLogic>(bus ? bus->getSubmodule("canBusLogic") : nullptr,
+                "canBusLogic of the connected bus", this);
+        if (logic->par("deliverAtBus").boolValue()) {
+            busLogic = logic;
+        }
+        outputBuffer = resolveModule<CanOutputBuffer>(getParentModule()->getParentModule()->getSubmodule("bufferOut"),
+                "bufferOut", this);
+        portOutput = resolveModule<CanPortOutput>(getParentModule()->getSubmodule("canPortOutput"),
+                "canPortOutput", this);
+    }
 }
 
 void CanPortInput::handleMessage(cMessage *msg) {
@@ -68,19 +94,13 @@ void CanPortInput::handleMessage(cMessage *msg) {
             scheduledDataFrame = nullptr;
         }
     } else if (CanDataFrame *df = dynamic_cast<CanDataFrame *>(msg)) {
-//        if (checkExistence(df)) {
-            if (checkExistence(df) && !amITheSendingNode()) {
-            int rcverr = intuniform(0, 99);
-            if (rcverr < errorperc) {
-                generateReceiveError(df);
+        if (acceptReception(df)) {
+            if (busLogic != nullptr) {
+                busLogic->registerReceiver(this);
+            } else {
+                receiveMessage(df);
+                return;
             }
-            receiveMessage(df);
-        } else {
-            if (scheduledDataFrame != nullptr) {
-                cancelEvent(scheduledDataFrame);
-            }
-            dropAndDelete(scheduledDataFrame);
-            scheduledDataFrame = nullptr;
         }
         delete msg;
     } else if (ErrorFrame *ef = dynamic_cast<ErrorFrame *>(msg)) {
@@ -89,12 +109,39 @@ void CanPortInput::handleMessage(cMessage *msg) {
     }
 }
 
+void CanPortInput::startReception(CanDataFrame *df) {
+    Enter_Method_Silent
+    ();
+    if (acceptReception(df)) {
+        busLogic->registerReceiver(this);
+    }
+}
+
+bool CanPortInput::acceptReception(CanDataFrame *df) {
+    if (checkExistence(df) && !amITheSendingNode() && !portOutput->isBusOff()) {
+        receiving = true;
+        errorFlagged = false;
+        discardReception = false;
+        int rcverr = intuniform(0, 99);
+        if (rcverr < errorperc) {
+            generateReceiveError(df);
+        }
+        return true;
+    }
+    if (scheduledDataFrame != nullptr) {
+        cancelEvent(scheduledDataFrame);
+    }
+    dropAndDelete(scheduledDataFrame);
+    scheduledDataFrame = nullptr;
+    return false;
+}
+
 void CanPortInput::receiveMessage(CanDataFrame *df) {
     if (scheduledDataFrame != nullptr) {
         cancelEvent(scheduledDataFrame);
     }
     delete (scheduledDataFrame);
-    scheduledDataFrame = df->dup();
+    scheduledDataFrame = df;
     scheduleAt((simTime() + calculateScheduleTiming(static_cast<int>(df->getBitLength()))),
             scheduledDataFrame);
 }
@@ -155,18 +202,21 @@ bool CanPortInput::checkIncomingDataFrames(unsigned int canID) {
     return false;
 }
 
-double CanPortInput::calculateScheduleTiming(int length) {
-    return static_cast<double> (length) / bandwidth;
+simtime_t CanPortInput::calculateScheduleTiming(int length) {
+    return bitDuration * length;
 }
 
 void CanPortInput::forwardDataFrame(CanDataFrame *df) {
+    if (receiving) {
+        receiving = false;
+        portOutput->receptionSucceeded();
+    }
     std::map<unsigned int, cGate*>::iterator it;
     it = incomingDataFrameIDs.find(df->getCanID());
     if (it != incomingDataFrameIDs.end()) {
         emit(rcvdDFSignal, df);
-        cPacket* payload_packet = df->decapsulate();
-        emit(receivedDFPayload, payload_packet);
-        df->encapsulate(payload_packet);
+        //the payload is shared with the other receivers, listeners only read it
+        emit(receivedDFPayload, const_cast<cPacket*>(df->getPayload()));
         sendDirect(df, it->second);
     }
 
@@ -175,22 +225,42 @@ void CanPortInput::forwardDataFrame(CanDataFrame *df) {
         it2 = outgoingDataFrameIDs.find(df->getCanID());
         if (it2 != outgoingDataFrameIDs.end()) {
             emit(rcvdRFSignal, df);
-            cPacket* payload_packet = df->decapsulate();
-            emit(receivedRFPayload, payload_packet);
-            df->encapsulate(payload_packet);
+            emit(receivedRFPayload, const_cast<cPacket*>(df->getPayload()));
             sendDirect(df, it2->second);
         }
     }
 }
 
+void CanPortInput::completeReception(CanDataFrame *df) {
+    Enter_Method_Silent
+    ();
+    if (discardReception) {
+        discardReception = false;
+        return;
+    }
+    forwardDataFrame(df->dup());
+}
+
 void CanPortInput::forwardOwnErrorFrame(ErrorFrame *ef) {
-    cModule* portOutput = getParentModule()->getSubmodule("canPortOutput");
+    if (portOutput->isErrorPassive()) {
+        if (scheduledDataFrame != nullptr) {
+            cancelAndDelete(scheduledDataFrame);
+            scheduledDataFrame = nullptr;
+        }
+        discardReception = true;
+        portOutput->handleBusError(receiving, false);
+        receiving = false;
+        delete ef;
+        return;
+    }
+    errorFlagged = true;
     sendDirect(ef, portOutput, "directIn");
 }
 
 void CanPortInput::handleExternErrorFrame(ErrorFrame *ef) {
-    CanPortOutput* portOutput =
-            dynamic_cast<CanPortOutput*> (getParentModule()->getSubmodule("canPortOutput"));
+    portOutput->handleBusError(receiving, errorFlagged);
+    receiving = false;
+    errorFlagged = false;
     portOutput->sendingCompleted();
 
     if ((checkOutgoingDataFrames(ef->getCanID())
@@ -216,21 +286,34 @@ void CanPortInput::handleExternErrorFrame(ErrorFrame *ef) {
 
 void CanPortInput::registerOutgoingDataFrame(unsigned int canID, cGate* outGate) {
     outgoingDataFrameIDs.insert(std::pair<unsigned int, cGate*>(canID, outGate));
+    publishToBus(canID);
 }
 
 void CanPortInput::registerOutgoingRemoteFrame(unsigned int canID) {
     std::vector<unsigned int>::iterator it;
     it = outgoingRemoteFrameIDs.begin();
     it = outgoingRemoteFrameIDs.insert(it, canID);
+    publishToBus(canID);
 }
 
 void CanPortInput::registerIncomingDataFrame(unsigned int canID, cGate* inGate) {
     incomingDataFrameIDs.insert(std::pair<int, cGate*>(canID, inGate));
+    publishToBus(canID);
+}
+
+void CanPortInput::publishToBus(unsigned int canID) {
+    if (busPort == nullptr) {
+        cGate *busGate = getParentModule()->getParentModule()->gate("gate$o")->getPathEndGate();
+        busPort = dynamic_cast<CanBusPort*>(busGate->getOwnerModule());
+        if (busPort == nullptr) {
+            return;
+        }
+        busPortGateIndex = busGate->getIndex();
+    }
+    busPort->subscribe(canID, busPortGateIndex);
 }
 
 bool CanPortInput::amITheSendingNode(){
-    CanOutputBuffer* outputBuffer =
-                dynamic_cast<CanOutputBuffer*> (getParentModule()->getParentModule()->getSubmodule("bufferOut"));
     return (outputBuffer->getCurrentFrame() != nullptr);
 }
 
@@ -32,11 +32,16 @@
 //FiCo4OMNeT
 #include "fico4omnet/base/FiCo4OMNeT_Defs.h"
 //Auto-generated messages
-#include "fico4omnet/linklayer/can/messages/CanDataFrame_m.h"
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
 #include "fico4omnet/linklayer/can/messages/ErrorFrame_m.h"
 
 namespace FiCo4OMNeT {
 
+class CanBusLogic;
+class CanBusPort;
+class CanOutputBuffer;
+class CanPortOutput;
+
 /**
  * @brief Received messages are initially handled in this module.
  *
@@ -75,11 +80,36 @@ public:
      */
     virtual void registerIncomingDataFrame(unsigned int canID, omnetpp::cGate* gate);
 
+    /**
+     * @brief Is called by the bus logic when the transmission of a frame this port registered for is completed.
+     *
+     * @param df the received frame, a copy is forwarded
+     */
+    virtual void completeReception(CanDataFrame *df);
+
+    /**
+     * @brief Is called by the bus logic at the start of a data frame if the bus delivers the received frames.
+     *
+     * Replaces the arrival of the frame at the port. The frame stays with the bus logic.
+     *
+     * @param df the frame which is transmitted on the bus
+     */
+    virtual void startReception(CanDataFrame *df);
+
 protected:
     /**
      * @brief Initialization of several variables.
+     *
+     * The modules this port interacts with are resolved in the second stage.
+     *
+     * @param stage the initialization stage
      */
-    virtual void initialize();
+    virtual void initialize(int stage);
+
+    /**
+     * @brief Number of initialization stages.
+     */
+    virtual int numInitStages() const { return 2; }
 
     /**
      * @brief Handles all received messages
@@ -134,12 +164,42 @@ private:
      */
     double bandwidth;
 
+    /**
+     * @brief Duration of one bit on the bus.
+     */
+    omnetpp::simtime_t bitDuration;
+
     /**
      * @brief Probability that an error for the received frame will occur.
      *
      */
     int errorperc;
 
+    /**
+     * @brief Bus port the node is connected to. Resolved when the first can ID is published.
+     */
+    CanBusPort *busPort;
+
+    /**
+     * @brief Index of the phygate of #busPort the node is connected to.
+     */
+    int busPortGateIndex;
+
+    /**
+     * @brief Bus logic that schedules the end of the reception. nullptr if the port schedules it itself.
+     */
+    CanBusLogic *busLogic;
+
+    /**
+     * @brief Output buffer of the node.
+     */
+    CanOutputBuffer *outputBuffer;
+
+    /**
+     * @brief Port output of the node.
+     */
+    CanPortOutput *portOutput;
+
     /**
      * @brief Currently scheduled data frame
      */
@@ -150,13 +210,47 @@ private:
      */
     ErrorFrame *scheduledErrorFrame;
 
+    /**
+     * @brief True while the node receives the frame on the bus. Used for the receive error counter.
+     */
+    bool receiving;
+
+    /**
+     * @brief True if the node sent an error flag for the current frame.
+     */
+    bool errorFlagged;
+
+    /**
+     * @brief True if the node signaled a passive error flag and discards the current frame.
+     */
+    bool discardReception;
+
+    /**
+     * @brief Publishes the can ID at the bus port so that frames with the ID are forwarded to this node.
+     *
+     * @param canID the can ID this node sends or receives
+     */
+    virtual void publishToBus(unsigned int canID);
+
     /**
      * @brief Incoming data frame is scheduled until transmission is completed.
      *
+     * The frame itself is scheduled, so the ownership is taken.
+     *
      * @param msg the incoming frame
      */
     virtual void receiveMessage(CanDataFrame *msg);
 
+    /**
+     * @brief Checks whether the port receives the frame and prepares the reception.
+     *
+     * A receive error is generated according to errorperc.
+     *
+     * @param df the frame which is transmitted on the bus
+     * @return true if the port receives the frame
+     */
+    virtual bool acceptReception(CanDataFrame *df);
+
     /**
      * @brief This method generates an error message for the received frame.
      *
@@ -205,9 +299,9 @@ private:
      *
      * @param length length of the frame in bit
      *
-     * @return the duration in seconds until frame transmission is completed
+     * @return the duration until frame transmission is completed
      */
-    virtual double calculateScheduleTiming(int length);
+    virtual omnetpp::simtime_t calculateScheduleTiming(int length);
 
     /**
      * @brief Forwards the received frame to the responsible module.
@@ -219,6 +313,9 @@ private:
     /**
      * @brief Sends the error frame to the output gate
      *
+     * An error passive node only sends a passive error flag. It does not interrupt the frame for the
+     * other nodes, so only the reception of this node is discarded.
+     *
      * @param ef the generated error frame
      */
     virtual void forwardOwnErrorFrame(ErrorFrame *ef);
@@ -28,8 +28,12 @@
 
 #include "fico4omnet/linklayer/can/CanPortOutput.h"
 
+#include "fico4omnet/buffer/can/CanOutputBuffer.h"
+#include "fico4omnet/bus/can/CanBusLogic.h"
+#include "fico4omnet/utilities/HelperFunctions.h"
+
 //Auto-generated messages
-#include "fico4omnet/linklayer/can/messages/CanDataFrame_m.h"
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
 
 namespace FiCo4OMNeT {
 
@@ -37,30 +41,59 @@ Define_Module(CanPortOutput);
 
 CanPortOutput::CanPortOutput(){
     this->bandwidth = 0;
+    this->bitDuration = SIMTIME_ZERO;
     this->errorperc = 0;
+    this->bitErrorModel = nullptr;
     this->scheduledErrorFrame = nullptr;
     this->errorReceived = false;
+    this->faultConfinement = false;
+    this->faultState = FaultConfinementState::ERROR_ACTIVE;
+    this->transmitErrorCounter = 0;
+    this->receiveErrorCounter = 0;
+    this->transmitting = false;
+    this->busOffRecovery = nullptr;
+    this->busOffSequences = 0;
+    this->busLogic = nullptr;
+    this->outputBuffer = nullptr;
+    this->visualize = false;
+    this->logEvents = false;
 }
 
 CanPortOutput::~CanPortOutput(){
     cancelAndDelete(scheduledErrorFrame);
+    cancelAndDelete(busOffRecovery);
 }
 
 void CanPortOutput::handleReceivedErrorFrame() {
     errorReceived = true;
     if (scheduledErrorFrame != nullptr && scheduledErrorFrame->isScheduled()) {
-        EV<< getParentModule()->getParentModule()->getId() << ": error frame wird gedescheduled\n";
+        if (logEvents) {
+            EV<< getParentModule()->getParentModule()->getId() << ": error frame wird gedescheduled\n";
+        }
         cancelEvent(scheduledErrorFrame);
         delete scheduledErrorFrame;
         scheduledErrorFrame = nullptr;
     }
 }
 
-void CanPortOutput::initialize() {
-    bandwidth = getParentModule()->getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule()->par("bandwidth");
-    errorperc = getParentModule()->getParentModule()->par("errorperc");
-    scheduledErrorFrame = new ErrorFrame();
-    initializeStatisticValues();
+void CanPortOutput::initialize(int stage) {
+    if (stage == 0) {
+        bandwidth = getParentModule()->getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule()->par("bandwidth");
+        bitDuration = bitTime(bandwidth);
+        errorperc = getParentModule()->getParentModule()->par("errorperc");
+        visualize = isVisualizationEnabled(this);
+        logEvents = !isHeadless();
+        faultConfinement = par("faultConfinement").boolValue();
+        busOffRecovery = new cMessage("busOffRecovery");
+        initializeStatisticValues();
+    } else if (stage == 1) {
+        cModule *bus = getParentModule()->getParentModule()->gate("gate$o")->getPathEndGate()->getOwnerModule()->getParentModule();
+        busLogic = resolveModule<CanBusLogic>(bus ? bus->getSubmodule("canBusLogic") : nullptr,
+                "canBusLogic of the connected bus", this);
+        bitErrorModel = busLogic->getBitErrorModel();
+        outputBuffer = resolveModule<CanOutputBuffer>(getParentModule()->getParentModule()->getSubmodule("bufferOut"),
+                "bufferOut", this);
+    }
 }
 
 void CanPortOutput::initializeStatisticValues(){
@@ -68,11 +101,22 @@ void CanPortOutput::initializeStatisticValues(){
     sentRFSignal = registerSignal("txRF");
     sendErrorsSignal = registerSignal("txEF");
     receiveErrorsSignal = registerSignal("rxEF");
+    faultStateSignal = registerSignal("faultState");
 }
 
 void CanPortOutput::handleMessage(cMessage *msg) {
-    if (ErrorFrame *ef = dynamic_cast<ErrorFrame *>(msg)) {
-        if (!errorReceived) {
+    if (msg == busOffRecovery) {
+        unsigned long observed = busLogic->getRecessiveSequences() - busOffSequences;
+        if (observed < BUSOFFRECOVERYSEQUENCES) {
+            //frames on the bus delayed the recovery, the remaining sequences take at least 11 bits each
+            scheduleAt(simTime() + bitDuration * ((BUSOFFRECOVERYSEQUENCES - observed) * 11), busOffRecovery);
+            return;
+        }
+        transmitErrorCounter = 0;
+        receiveErrorCounter = 0;
+        changeFaultState(FaultConfinementState::ERROR_ACTIVE);
+    } else if (ErrorFrame *ef = dynamic_cast<ErrorFrame *>(msg)) {
+        if (!errorReceived && !isBusOff()) {
             if (ef->getKind() < 2) { //TODO magic number
                 emit(sendErrorsSignal, ef);
             } else {
@@ -82,32 +126,38 @@ void CanPortOutput::handleMessage(cMessage *msg) {
             send(msg, "out");
             scheduledErrorFrame = nullptr;
         } else {
+            if (msg == scheduledErrorFrame) {
+                scheduledErrorFrame = nullptr;
+            }
             delete msg;
         }
     } else {
-        CanDataFrame *df;
+        CanDataFrame *df = check_and_cast<CanDataFrame *>(msg);
         colorBusy();
         errorReceived = false;
-        if ((df = dynamic_cast<CanDataFrame *>(msg)) && (errorperc > 0)) {
+        transmitting = true;
+        int position = -1;
+        int kind = 0; //0: Bit-Error, 1: Form-Error
+        if (bitErrorModel != nullptr) {
+            //the model has to see every frame on the bus, also if the node itself produces an error
+            position = static_cast<int>(bitErrorModel->nextErrorPosition(simTime(), df->getBitLength()));
+        }
+        if (errorperc > 0) {
             int senderr = intuniform(0, 99);
             if (senderr < errorperc) {
-                ErrorFrame *errself = new ErrorFrame("senderror");
-                int position = intuniform(0, static_cast<int> (df->getBitLength()) - MAXERRORFRAMESIZE);
-                errself->setKind(intuniform(0, 1)); //0: Bit-Error, 1: Form-Error
-                errself->setCanID(df->getCanID());
-                if (position > 0)
-                    position--;
-                errself->setPos(position);
-                if (scheduledErrorFrame != nullptr && scheduledErrorFrame->isScheduled()) {
-                    cancelEvent(scheduledErrorFrame);
-                    delete(scheduledErrorFrame);
-                    scheduledErrorFrame = nullptr;
+                int errorPosition = intuniform(0, static_cast<int> (df->getBitLength()) - MAXERRORFRAMESIZE);
+                int errorKind = intuniform(0, 1);
+                if (errorPosition > 0)
+                    errorPosition--;
+                if (position < 0 || errorPosition < position) {
+                    position = errorPosition;
+                    kind = errorKind;
                 }
-                scheduledErrorFrame = errself;
-                scheduleAt((simTime() + calculateScheduleTiming(position)),
-                        scheduledErrorFrame);
             }
         }
+        if (position >= 0) {
+            scheduleSendError(df, position, kind);
+        }
         if (df->getRtr()) {
             emit(sentRFSignal, df);
         } else {
@@ -117,15 +167,102 @@ void CanPortOutput::handleMessage(cMessage *msg) {
     }
 }
 
-double CanPortOutput::calculateScheduleTiming(int length) {
-    return static_cast<double> (length) / (bandwidth);
+void CanPortOutput::scheduleSendError(CanDataFrame *df, int position, int kind) {
+    ErrorFrame *errself = new ErrorFrame("senderror");
+    errself->setKind(kind);
+    errself->setCanID(df->getCanID());
+    errself->setPos(position);
+    cancelAndDelete(scheduledErrorFrame);
+    scheduledErrorFrame = errself;
+    scheduleAt((simTime() + calculateScheduleTiming(position)), scheduledErrorFrame);
+}
+
+simtime_t CanPortOutput::calculateScheduleTiming(int length) {
+    return bitDuration * length;
 }
 
 void CanPortOutput::sendingCompleted(){
+    if (transmitting) {
+        transmitting = false;
+        if (faultConfinement && transmitErrorCounter > 0) {
+            transmitErrorCounter--;
+            updateFaultState();
+        }
+    }
     colorIdle();
 }
 
+void CanPortOutput::handleBusError(bool receiving, bool flaggedByNode) {
+    Enter_Method_Silent
+    ();
+    if (!faultConfinement || isBusOff()) {
+        transmitting = false;
+        return;
+    }
+    if (transmitting) {
+        transmitting = false;
+        transmitErrorCounter += 8;
+    } else if (receiving) {
+        receiveErrorCounter += flaggedByNode ? 8 : 1;
+    } else {
+        return;
+    }
+    updateFaultState();
+}
+
+void CanPortOutput::receptionSucceeded() {
+    Enter_Method_Silent
+    ();
+    if (!faultConfinement || receiveErrorCounter == 0) {
+        return;
+    }
+    if (receiveErrorCounter > ERRORPASSIVELIMIT) {
+        //ISO 11898: set to a value between 119 and 127
+        receiveErrorCounter = ERRORPASSIVELIMIT;
+    } else {
+        receiveErrorCounter--;
+    }
+    updateFaultState();
+}
+
+void CanPortOutput::updateFaultState() {
+    FaultConfinementState state = FaultConfinementState::ERROR_ACTIVE;
+    if (transmitErrorCounter > BUSOFFLIMIT) {
+        state = FaultConfinementState::BUS_OFF;
+    } else if (transmitErrorCounter > ERRORPASSIVELIMIT || receiveErrorCounter > ERRORPASSIVELIMIT) {
+        state = FaultConfinementState::ERROR_PASSIVE;
+    }
+    if (state != faultState) {
+        changeFaultState(state);
+    }
+}
+
+void CanPortOutput::changeFaultState(FaultConfinementState state) {
+    FaultConfinementState previous = faultState;
+    faultState = state;
+    emit(faultStateSignal, static_cast<long>(state));
+    if (logEvents) {
+        EV << getParentModule()->getParentModule()->getFullName() << ": fault confinement state "
+                << static_cast<int>(state) << " (TEC " << transmitErrorCounter << ", REC " << receiveErrorCounter << ")\n";
+    }
+    if (state == FaultConfinementState::BUS_OFF) {
+        if (visualize) {
+            getParentModule()->getParentModule()->bubble("bus-off");
+        }
+        colorIdle();
+        outputBuffer->enterBusOff();
+        //the bus is monitored for 128 occurrences of 11 consecutive recessive bits
+        busOffSequences = busLogic->getRecessiveSequences();
+        scheduleAt(simTime() + bitDuration * (BUSOFFRECOVERYSEQUENCES * 11), busOffRecovery);
+    } else if (previous == FaultConfinementState::BUS_OFF) {
+        outputBuffer->leaveBusOff();
+    }
+}
+
 void CanPortOutput::colorBusy(){
+    if (!visualize) {
+        return;
+    }
     getParentModule()->getParentModule()->getDisplayString().setTagArg("i", 1, "yellow");
     getParentModule()->getParentModule()->gate("gate$i")->getDisplayString().setTagArg("ls", 0, "yellow");
     getParentModule()->getParentModule()->gate("gate$i")->getDisplayString().setTagArg("ls", 1, "3");
@@ -134,6 +271,9 @@ void CanPortOutput::colorBusy(){
 }
 
 void CanPortOutput::colorIdle(){
+    if (!visualize) {
+        return;
+    }
     getParentModule()->getParentModule()->getDisplayString().setTagArg("i", 1, "");
     getParentModule()->getParentModule()->gate("gate$i")->getDisplayString().setTagArg("ls", 0, "black");
     getParentModule()->getParentModule()->gate("gate$i")->getDisplayString().setTagArg("ls", 1, "1");
@@ -142,6 +282,9 @@ void CanPortOutput::colorIdle(){
 }
 
 void CanPortOutput::colorError(){
+    if (!visualize) {
+        return;
+    }
     getParentModule()->getParentModule()->getDisplayString().setTagArg("i", 1, "red");
     getParentModule()->getParentModule()->gate("gate$i")->getDisplayString().setTagArg("ls", 0, "red");
     getParentModule()->getParentModule()->gate("gate$i")->getDisplayString().setTagArg("ls", 1, "3");
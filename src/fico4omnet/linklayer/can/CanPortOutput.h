@@ -31,14 +31,19 @@
 
 //FiCo4OMNeT
 #include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+#include "fico4omnet/bus/can/CanBitErrorModel.h"
 
 //Auto-generated messages
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
 #include "fico4omnet/linklayer/can/messages/ErrorFrame_m.h"
 
 namespace FiCo4OMNeT {
 
 using namespace omnetpp;
 
+class CanOutputBuffer;
+class CanBusLogic;
+
 /**
  * @brief Outgoing messages are handled in this module.
  *
@@ -49,6 +54,13 @@ using namespace omnetpp;
 class CanPortOutput: public cSimpleModule {
 
 public:
+    /**
+     * @brief Fault confinement states of a CAN node according to ISO 11898.
+     */
+    enum class FaultConfinementState {
+        ERROR_ACTIVE = 0, ERROR_PASSIVE = 1, BUS_OFF = 2
+    };
+
     /**
      * @brief Constructor
      */
@@ -69,11 +81,52 @@ public:
      */
     virtual void sendingCompleted();
 
+    /**
+     * @brief Updates the error counters for an error frame on the bus.
+     *
+     * The transmit error counter is increased by 8 if this node transmits the frame. Otherwise the receive
+     * error counter is increased by 1 if the node receives the frame, or by 8 if the node flagged the error itself.
+     *
+     * @param receiving true if the node receives the interrupted frame
+     * @param flaggedByNode true if the node detected the error and sent the error flag
+     */
+    virtual void handleBusError(bool receiving, bool flaggedByNode);
+
+    /**
+     * @brief Decreases the receive error counter after a successful reception.
+     */
+    virtual void receptionSucceeded();
+
+    /**
+     * @brief Returns whether the node is error passive. Error passive nodes only send passive error flags.
+     *
+     * @return true if the node is error passive
+     */
+    bool isErrorPassive() const {
+        return faultState == FaultConfinementState::ERROR_PASSIVE;
+    }
+
+    /**
+     * @brief Returns whether the node is in the bus-off state and does not take part in the bus traffic.
+     *
+     * @return true if the node is bus-off
+     */
+    bool isBusOff() const {
+        return faultState == FaultConfinementState::BUS_OFF;
+    }
+
 protected:
     /**
-     * @brief Initialization of the module.
+     * @brief Initialization of the module. The bit error model of the bus is resolved in the second stage.
+     *
+     * @param stage the initialization stage
      */
-    virtual void initialize();
+    virtual void initialize(int stage);
+
+    /**
+     * @brief Number of initialization stages.
+     */
+    virtual int numInitStages() const { return 2; }
 
     /**
      * @brief Handles all received messages
@@ -88,6 +141,26 @@ private:
      */
     static const int MAXERRORFRAMESIZE = 12;
 
+    /**
+     * @brief Number of sequences of 11 recessive bits a bus-off node has to observe before it becomes error active again.
+     */
+    static const unsigned long BUSOFFRECOVERYSEQUENCES = 128;
+
+    /**
+     * @brief Counters above this value make the node error passive.
+     */
+    static const unsigned int ERRORPASSIVELIMIT = 127;
+
+    /**
+     * @brief A transmit error counter above this value makes the node bus-off.
+     */
+    static const unsigned int BUSOFFLIMIT = 255;
+
+    /**
+     * @brief Simsignal for changes of the fault confinement state.
+     */
+    simsignal_t faultStateSignal;
+
     /**
      * @brief Simsignal for sent data frames.
      */
@@ -113,12 +186,32 @@ private:
      */
     double bandwidth;
 
+    /**
+     * @brief True if the state of the port is visualized in the graphical environment.
+     */
+    bool visualize;
+
+    /**
+     * @brief True if per-frame events are logged.
+     */
+    bool logEvents;
+
+    /**
+     * @brief Duration of one bit on the bus.
+     */
+    omnetpp::simtime_t bitDuration;
+
     /**
      * @brief Probability that an error for the received frame will occur.
      *
      */
     int errorperc;
 
+    /**
+     * @brief Bit error model of the bus. nullptr if the bus has no bit error rate.
+     */
+    CanBitErrorModel *bitErrorModel;
+
     /**
      * @brief The currently scheduled error frame.
      */
@@ -129,19 +222,85 @@ private:
      */
     bool errorReceived;
 
+    /**
+     * @brief True if the fault confinement is enabled.
+     */
+    bool faultConfinement;
+
+    /**
+     * @brief Current fault confinement state of the node.
+     */
+    FaultConfinementState faultState;
+
+    /**
+     * @brief Transmit error counter (TEC).
+     */
+    unsigned int transmitErrorCounter;
+
+    /**
+     * @brief Receive error counter (REC).
+     */
+    unsigned int receiveErrorCounter;
+
+    /**
+     * @brief True while a frame of this node is transmitted.
+     */
+    bool transmitting;
+
+    /**
+     * @brief Self message for the end of the bus-off recovery.
+     */
+    cMessage *busOffRecovery;
+
+    /**
+     * @brief Number of sequences of 11 recessive bits on the bus when the node became bus-off.
+     */
+    unsigned long busOffSequences;
+
+    /**
+     * @brief Bus logic of the connected bus. Counts the sequences of recessive bits during the bus-off recovery.
+     */
+    CanBusLogic *busLogic;
+
+    /**
+     * @brief Output buffer of the node.
+     */
+    CanOutputBuffer *outputBuffer;
+
+    /**
+     * @brief Derives the fault confinement state from the error counters and handles state changes.
+     */
+    virtual void updateFaultState();
+
+    /**
+     * @brief Emits the fault confinement state and enters or leaves the bus-off state.
+     *
+     * @param state the new state
+     */
+    virtual void changeFaultState(FaultConfinementState state);
+
     /**
      * @brief Initializes the values needed for the stats collection.
      */
     virtual void initializeStatisticValues();
 
+    /**
+     * @brief Schedules an error frame that interrupts the transmission of the frame.
+     *
+     * @param df the frame that is transmitted
+     * @param position bit position of the error in the frame
+     * @param kind kind of the error (0: bit error, 1: form error)
+     */
+    virtual void scheduleSendError(CanDataFrame *df, int position, int kind);
+
     /**
      * @brief Calculates when the frame is ready to be forwarded based on the number of bits.
      *
      * @param length length of the frame in bit
      *
-     * @return the duration in seconds until frame transmission is completed
+     * @return the duration until frame transmission is completed
      */
-    virtual double calculateScheduleTiming(int length);
+    virtual omnetpp::simtime_t calculateScheduleTiming(int length);
 
     /**
      * @brief Colors the connection to the bus to represent it is busy.
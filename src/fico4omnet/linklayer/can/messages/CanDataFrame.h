@@ -0,0 +1,101 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANDATAFRAME_H_
+#define FICO4OMNET_CANDATAFRAME_H_
+
+//Auto-generated messages
+#include "fico4omnet/linklayer/can/messages/CanDataFrame_m.h"
+
+namespace FiCo4OMNeT {
+
+using namespace omnetpp;
+
+/**
+ * @brief Redefines CanDataFrame_Base and adds read access to the shared payload.
+ *
+ * Copies of a frame share their encapsulated payload. getEncapsulatedPacket()
+ * detaches and thereby duplicates a shared payload, getPayload() does not.
+ */
+class CanDataFrame : public CanDataFrame_Base
+{
+    private:
+        /**
+         * @brief The encapsulated packet, kept in sync with cPacket.
+         */
+        mutable cPacket *payload_var;
+
+    public:
+        CanDataFrame(const char *name = nullptr, short kind = 0) :
+            CanDataFrame_Base(name, kind)
+        {
+            payload_var = nullptr;
+        }
+
+        CanDataFrame(const CanDataFrame& other) :
+            CanDataFrame_Base(other)
+        {
+            payload_var = other.payload_var;
+        }
+
+        CanDataFrame& operator=(const CanDataFrame& other)
+        {
+            if (this == &other) {
+                return *this;
+            }
+            CanDataFrame_Base::operator=(other);
+            payload_var = other.payload_var;
+            return *this;
+        }
+
+        virtual CanDataFrame *dup() const override
+        {
+            return new CanDataFrame(*this);
+        }
+
+        virtual void encapsulate(cPacket *packet) override;
+
+        virtual cPacket *decapsulate() override;
+
+        virtual cPacket *getEncapsulatedPacket() const override;
+
+        /**
+         * @brief Returns the payload without detaching it from the other copies of this frame.
+         *
+         * The payload must not be modified through the returned pointer.
+         *
+         * @return the encapsulated packet or nullptr
+         */
+        const cPacket* getPayload() const
+        {
+            return payload_var;
+        }
+};
+
+}
+#endif
@@ -17,6 +17,7 @@
 
 #include "fico4omnet/scheduler/flexray/FRScheduler.h"
 #include "fico4omnet/synchronisation/flexray/FRSync.h"
+#include "fico4omnet/utilities/HelperFunctions.h"
 
 //Auto-generated messages
 #include "fico4omnet/scheduler/flexray/SchedulerMessage_m.h"
@@ -27,13 +28,25 @@ Define_Module(FRPortInput);
 
 FRPortInput::FRPortInput(){
     this->bandwidth = 0;
+    this->frScheduler = nullptr;
+    this->frSync = nullptr;
+    this->visualize = false;
+    this->logEvents = false;
 }
 
-void FRPortInput::initialize() {
-    bandwidth = getParentModule()->getParentModule()->par("bandwidth").doubleValue();
+void FRPortInput::initialize(int stage) {
+    if (stage == 0) {
+        bandwidth = getParentModule()->getParentModule()->par("bandwidth").doubleValue();
+        visualize = isVisualizationEnabled(this);
+        logEvents = !isHeadless();
 
-    rcvdSFSignal = registerSignal("receivedCompleteSF");
-    rcvdDFSignal = registerSignal("receivedCompleteDF");
+        rcvdSFSignal = registerSignal("receivedCompleteSF");
+        rcvdDFSignal = registerSignal("receivedCompleteDF");
+    } else if (stage == 1) {
+        frScheduler = resolveModule<FRScheduler>(getParentModule()->getParentModule()->getSubmodule("frScheduler"),
+                "frScheduler", this);
+        frSync = resolveModule<FRSync>(getParentModule()->getParentModule()->getSubmodule("frSync"), "frSync", this);
+    }
 }
 
 void FRPortInput::handleMessage(cMessage *msg) {
@@ -53,9 +66,6 @@ void FRPortInput::handleMessage(cMessage *msg) {
 }
 
 void FRPortInput::receivedExternMessage(FRFrame *frMsg) {
-    FRScheduler *frScheduler =
-            dynamic_cast<FRScheduler*> (getParentModule()->getParentModule()->getSubmodule(
-                    "frScheduler"));
     if (frMsg->getKind() == DYNAMIC_EVENT) {
         frScheduler->dynamicFrameReceived(frMsg->getByteLength(),
                 static_cast<unsigned int> (frMsg->getChannel()));
@@ -63,16 +73,17 @@ void FRPortInput::receivedExternMessage(FRFrame *frMsg) {
         if (frScheduler->getSlotCounter()
                 == static_cast<unsigned int> (frMsg->getFrameID())){
             if (frMsg->getSyncFrameIndicator()) {
-                FRSync *frSync =
-                        dynamic_cast<FRSync*> (getParentModule()->getParentModule()->getSubmodule(
-                                "frSync"));
                 frSync->storeDeviationValue(frMsg->getFrameID(),
                         frMsg->getCycleNumber() % 2, frMsg->getChannel(),
                         frScheduler->calculateDeviationValue(), true);
             }
         } else {
-            EV << "received static frame in wrong slot!\n";
-            bubble("static frame in wrong slot");
+            if (logEvents) {
+                EV << "received static frame in wrong slot!\n";
+            }
+            if (visualize) {
+                bubble("static frame in wrong slot");
+            }
             //TODO signal for stats
         }
     }
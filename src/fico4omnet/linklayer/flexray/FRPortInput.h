@@ -24,6 +24,9 @@
 
 namespace FiCo4OMNeT {
 
+class FRScheduler;
+class FRSync;
+
 /**
  * @brief Received messages are initially handled in this module.
  *
@@ -40,9 +43,18 @@ public:
     
 protected:
     /**
+     * @brief Initialization of the module.
+     *
+     * The scheduler and the synchronisation module are resolved in the second stage.
      *
+     * @param stage the initialization stage
+     */
+    virtual void initialize(int stage);
+
+    /**
+     * @brief Number of initialization stages.
      */
-    virtual void initialize();
+    virtual int numInitStages() const { return 2; }
 
     /**
      * @brief Handles all received messages
@@ -57,6 +69,26 @@ private:
      */
     double bandwidth;
 
+    /**
+     * @brief True if the port shows bubbles in the graphical environment.
+     */
+    bool visualize;
+
+    /**
+     * @brief True if per-frame events are logged.
+     */
+    bool logEvents;
+
+    /**
+     * @brief Scheduler of the node.
+     */
+    FRScheduler *frScheduler;
+
+    /**
+     * @brief Synchronisation module of the node.
+     */
+    FRSync *frSync;
+
     /**
      * @brief Simsignal for received static frames.
      */
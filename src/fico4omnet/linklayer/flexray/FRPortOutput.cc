@@ -15,6 +15,8 @@
 
 #include "fico4omnet/linklayer/flexray/FRPortOutput.h"
 
+#include "fico4omnet/utilities/HelperFunctions.h"
+
 //Auto-generated messages
 #include "fico4omnet/linklayer/flexray/messages/FRFrame_m.h"
 
@@ -24,10 +26,12 @@ Define_Module(FRPortOutput);
 
 FRPortOutput::FRPortOutput(){
     this->bandwidth = 0;
+    this->visualize = false;
 }
 
 void FRPortOutput::initialize() {
     bandwidth = getParentModule()->getParentModule()->par("bandwidth").doubleValue();
+    visualize = isVisualizationEnabled(this);
 //    initializeStatisticValues();
 }
 
@@ -64,6 +68,9 @@ void FRPortOutput::sendingCompleted() {
 }
 
 void FRPortOutput::colorBusy() {
+    if (!visualize) {
+        return;
+    }
     getParentModule()->getParentModule()->getDisplayString().setTagArg("i", 1,
             "yellow");
     getParentModule()->getParentModule()->gate("gate$i")->getDisplayString().setTagArg(
@@ -77,6 +84,9 @@ void FRPortOutput::colorBusy() {
 }
 
 void FRPortOutput::colorIdle() {
+    if (!visualize) {
+        return;
+    }
     getParentModule()->getParentModule()->getDisplayString().setTagArg("i", 1,
             "");
     getParentModule()->getParentModule()->gate("gate$i")->getDisplayString().setTagArg(
@@ -78,6 +78,11 @@ private:
      */
     int bandwidth;
 
+    /**
+     * @brief True if the state of the port is visualized in the graphical environment.
+     */
+    bool visualize;
+
 //    /**
 //     * @brief Initializes the values needed for the stats collection.
 //     */
@@ -0,0 +1,96 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/scheduler/can/CanFrameCalendar.h"
+
+//Std
+#include <algorithm>
+
+namespace FiCo4OMNeT {
+
+CanFrameCalendar::CanFrameCalendar() {
+    this->nextSequence = 0;
+}
+
+bool CanFrameCalendar::later(const Entry &a, const Entry &b) {
+    if (a.time != b.time) {
+        return a.time > b.time;
+    }
+    return a.sequence > b.sequence;
+}
+
+void CanFrameCalendar::insert(CanDataFrame *frame, simtime_t time, cModule *module) {
+    Entry entry;
+    entry.time = time;
+    entry.sequence = nextSequence++;
+    entry.frame = frame;
+    entry.module = module;
+    entries.push_back(entry);
+    std::push_heap(entries.begin(), entries.end(), later);
+}
+
+bool CanFrameCalendar::remove(CanDataFrame *frame) {
+    for (std::vector<Entry>::iterator it = entries.begin(); it != entries.end(); ++it) {
+        if (it->frame == frame) {
+            entries.erase(it);
+            std::make_heap(entries.begin(), entries.end(), later);
+            return true;
+        }
+    }
+    return false;
+}
+
+simtime_t CanFrameCalendar::nextTime() const {
+    if (entries.empty()) {
+        throw cRuntimeError("The frame calendar is empty.");
+    }
+    return entries.front().time;
+}
+
+bool CanFrameCalendar::isDue(simtime_t now) const {
+    return !entries.empty() && entries.front().time <= now;
+}
+
+CanDataFrame* CanFrameCalendar::pop(cModule **module) {
+    if (entries.empty()) {
+        throw cRuntimeError("The frame calendar is empty.");
+    }
+    std::pop_heap(entries.begin(), entries.end(), later);
+    CanDataFrame *frame = entries.back().frame;
+    if (module != nullptr) {
+        *module = entries.back().module;
+    }
+    entries.pop_back();
+    return frame;
+}
+
+void CanFrameCalendar::clear() {
+    entries.clear();
+}
+
+}
@@ -0,0 +1,138 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANFRAMECALENDAR_H_
+#define FICO4OMNET_CANFRAMECALENDAR_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+//Std
+#include <cstdint>
+#include <vector>
+//Auto-generated messages
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
+
+namespace FiCo4OMNeT {
+
+using namespace omnetpp;
+
+/**
+ * @brief Sorted calendar of the next transmission times of periodic CAN frames.
+ *
+ * The calendar allows a source application to multiplex all of its periodic frames onto a single self message.
+ * Entries are kept in a binary heap ordered by transmission time; frames due at the same time are returned in the
+ * order they were inserted, which is the order the future event set used for individually scheduled frames.
+ * Each entry can name the module the frame belongs to, so that a calendar can be shared by several source
+ * applications. The calendar does not own the frames.
+ */
+class CanFrameCalendar {
+public:
+    /**
+     * @brief Constructor
+     */
+    CanFrameCalendar();
+
+    /**
+     * @brief Inserts the frame with the given transmission time.
+     *
+     * @param frame the periodic frame
+     * @param time the next transmission time of the frame
+     * @param module the module the frame belongs to
+     */
+    void insert(CanDataFrame *frame, simtime_t time, cModule *module = nullptr);
+
+    /**
+     * @brief Removes the frame from the calendar.
+     *
+     * @param frame the periodic frame
+     *
+     * @return true if the frame was part of the calendar
+     */
+    bool remove(CanDataFrame *frame);
+
+    /**
+     * @brief Returns the earliest transmission time. Only valid if the calendar is not empty.
+     */
+    simtime_t nextTime() const;
+
+    /**
+     * @brief Returns true if the earliest frame is due at the given time.
+     */
+    bool isDue(simtime_t now) const;
+
+    /**
+     * @brief Removes and returns the earliest frame. Only valid if the calendar is not empty.
+     *
+     * @param module if not nullptr, receives the module the frame belongs to
+     */
+    CanDataFrame* pop(cModule **module = nullptr);
+
+    /**
+     * @brief Returns the number of frames in the calendar.
+     */
+    size_t size() const { return entries.size(); }
+
+    /**
+     * @brief Returns true if the calendar contains no frames.
+     */
+    bool empty() const { return entries.empty(); }
+
+    /**
+     * @brief Removes all frames from the calendar.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief An entry of the calendar.
+     */
+    struct Entry {
+        simtime_t time;
+        uint64_t sequence;
+        CanDataFrame *frame;
+        cModule *module;
+    };
+
+    /**
+     * @brief Returns true if entry a is due after entry b.
+     */
+    static bool later(const Entry &a, const Entry &b);
+
+    /**
+     * @brief Binary min-heap of the entries.
+     */
+    std::vector<Entry> entries;
+
+    /**
+     * @brief Insertion counter used to keep frames due at the same time in insertion order.
+     */
+    uint64_t nextSequence;
+};
+
+}
+#endif /* FICO4OMNET_CANFRAMECALENDAR_H_ */
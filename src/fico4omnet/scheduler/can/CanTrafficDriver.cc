@@ -0,0 +1,89 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "fico4omnet/scheduler/can/CanTrafficDriver.h"
+
+#include "fico4omnet/applications/can/source/CanTrafficSourceAppBase.h"
+
+namespace FiCo4OMNeT {
+
+Define_Module(CanTrafficDriver);
+
+CanTrafficDriver::CanTrafficDriver() {
+    this->batchSizeSignal = 0;
+    this->releaseTimer = nullptr;
+}
+
+CanTrafficDriver::~CanTrafficDriver() {
+    calendar.clear();
+    cancelAndDelete(releaseTimer);
+}
+
+void CanTrafficDriver::initialize() {
+    batchSizeSignal = registerSignal("batchSize");
+    releaseTimer = new cMessage("releaseTimer");
+}
+
+void CanTrafficDriver::schedulePeriodicFrame(CanTrafficSourceAppBase *app, CanDataFrame *frame, simtime_t time) {
+    Enter_Method_Silent
+    ();
+    calendar.insert(frame, time, app);
+    if (!releaseTimer->isScheduled() || time < releaseTimer->getArrivalTime()) {
+        updateReleaseTimer();
+    }
+}
+
+void CanTrafficDriver::handleMessage(cMessage *msg) {
+    if (msg != releaseTimer) {
+        throw cRuntimeError("CanTrafficDriver received an invalid message.");
+    }
+    //collect first, frames rescheduled for the current time are released with the next timer event
+    while (calendar.isDue(simTime())) {
+        cModule *app = nullptr;
+        CanDataFrame *frame = calendar.pop(&app);
+        dueFrames.push_back(std::make_pair(check_and_cast<CanTrafficSourceAppBase*>(app), frame));
+    }
+    emit(batchSizeSignal, static_cast<unsigned long>(dueFrames.size()));
+    for (std::vector<std::pair<CanTrafficSourceAppBase*, CanDataFrame*> >::iterator it = dueFrames.begin();
+            it != dueFrames.end(); ++it) {
+        it->first->releasePeriodicFrame(it->second);
+    }
+    dueFrames.clear();
+    updateReleaseTimer();
+}
+
+void CanTrafficDriver::updateReleaseTimer() {
+    if (calendar.empty()) {
+        cancelEvent(releaseTimer);
+    } else if (!releaseTimer->isScheduled() || releaseTimer->getArrivalTime() != calendar.nextTime()) {
+        cancelEvent(releaseTimer);
+        scheduleAt(calendar.nextTime(), releaseTimer);
+    }
+}
+
+}
@@ -0,0 +1,116 @@
+//Copyright (c) 2014, CoRE Research Group, Hamburg University of Applied Sciences
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification,
+//are permitted provided that the following conditions are met:
+//
+//1. Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+//2. Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+//3. Neither the name of the copyright holder nor the names of its contributors
+//   may be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+//ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef FICO4OMNET_CANTRAFFICDRIVER_H_
+#define FICO4OMNET_CANTRAFFICDRIVER_H_
+
+//FiCo4OMNeT
+#include "fico4omnet/base/FiCo4OMNeT_Defs.h"
+#include "fico4omnet/scheduler/can/CanFrameCalendar.h"
+
+//Std
+#include <utility>
+#include <vector>
+
+namespace FiCo4OMNeT {
+
+using namespace omnetpp;
+
+class CanTrafficSourceAppBase;
+
+/**
+ * @brief Releases the periodic frames of all source applications attached to a can bus.
+ *
+ * The driver owns the periodic schedule of the source applications of the bus. All frames that are due at the
+ * same time are released in one batch on a single self message and handed directly to the output buffers of
+ * their nodes. The source applications still calculate the next transmission time of their frames, so the
+ * drift of the node clocks and the stop times of the applications are applied as before.
+ */
+class CanTrafficDriver : public cSimpleModule {
+public:
+    /**
+     * @brief Constructor
+     */
+    CanTrafficDriver();
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~CanTrafficDriver();
+
+    /**
+     * @brief Schedules the transmission of a periodic frame.
+     *
+     * @param app the source application the frame belongs to
+     * @param frame the periodic frame, the ownership stays with the application
+     * @param time the transmission time
+     */
+    virtual void schedulePeriodicFrame(CanTrafficSourceAppBase *app, CanDataFrame *frame, simtime_t time);
+
+protected:
+    /**
+     * @brief Initialization of the module.
+     */
+    virtual void initialize();
+
+    /**
+     * @brief Releases all frames due at the current time.
+     *
+     * @param msg the release timer
+     */
+    virtual void handleMessage(cMessage *msg);
+
+private:
+    /**
+     * @brief Signal for the number of frames released at once.
+     */
+    simsignal_t batchSizeSignal;
+
+    /**
+     * @brief Next transmission times of the periodic frames of all source applications.
+     */
+    CanFrameCalendar calendar;
+
+    /**
+     * @brief Single self message for the release of all periodic frames.
+     */
+    cMessage *releaseTimer;
+
+    /**
+     * @brief Frames and their applications due at the current #releaseTimer event.
+     */
+    std::vector<std::pair<CanTrafficSourceAppBase*, CanDataFrame*> > dueFrames;
+
+    /**
+     * @brief Schedules the #releaseTimer for the earliest frame in the #calendar.
+     */
+    void updateReleaseTimer();
+};
+
+}
+#endif /* FICO4OMNET_CANTRAFFICDRIVER_H_ */
@@ -16,6 +16,7 @@
 #include "fico4omnet/scheduler/flexray/FRScheduler.h"
 
 #include "fico4omnet/synchronisation/flexray/FRSync.h"
+#include "fico4omnet/utilities/HelperFunctions.h"
 
 //Auto-generated messages
 #include "fico4omnet/scheduler/flexray/SchedulerMessageEvents_m.h"
@@ -29,6 +30,7 @@ FRScheduler::FRScheduler(){
     this->lastCycleTicks = 0;
     this->gateFRApp = nullptr;
     this->newCyclemsg = nullptr;
+    this->frSync = nullptr;
     this->maxDriftChange = 0;
     this->maxDrift = 0;
     this->currentTick = 0;
@@ -52,6 +54,7 @@ FRScheduler::FRScheduler(){
     this->zRateCorrection = 0;
     this->additionalMinislotsChA = 0;
     this->additionalMinislotsChB = 0;
+    this->logEvents = false;
 
 }
 
@@ -74,6 +77,8 @@ void FRScheduler::initialize() {
     gdMinislotActionPointOffset = getParentModule()->par(
             "gdMinislotActionPointOffset"); //[MT]
     bandwidth = getParentModule()->par("bandwidth").doubleValue();
+    logEvents = !isHeadless();
+    frSync = resolveModule<FRSync>(getParentModule()->getSubmodule("frSync"), "frSync", this);
 //    syncFrame = getParentModule()->par("syncFrame");
 
     currentTick = pdMicrotick;
@@ -111,11 +116,12 @@ void FRScheduler::handleMessage(cMessage *msg) {
         scheduleAt(lastCycleStart + (getCycleTicks() - gdNIT) * gdMacrotick,
                 new SchedulerEvent("NIT", NIT_EVENT));
         newCyclemsg = msg;
-        EV << vCycleCounter << " NEW CYCLE!! New Macrotick = " << gdMacrotick
-                  << "!! Next cycle in "
-                  << lastCycleStart + gdMacrotick * getCycleTicks() << "\n";
+        if (logEvents) {
+            EV << vCycleCounter << " NEW CYCLE!! New Macrotick = " << gdMacrotick
+                      << "!! Next cycle in "
+                      << lastCycleStart + gdMacrotick * getCycleTicks() << "\n";
+        }
     } else if (msg->isSelfMessage() && msg->getKind() == NIT_EVENT) {
-        FRSync *frSync = dynamic_cast<FRSync*> (getParentModule()->getSubmodule("frSync"));
         if (vCycleCounter % 2 == 0) {
             frSync->offsetCorrectionCalculation(vCycleCounter);
         } else {
@@ -125,8 +131,10 @@ void FRScheduler::handleMessage(cMessage *msg) {
             correctNewCycle();
             frSync->resetTables();
         }
-        EV << "Offset: " << zOffsetCorrection << " Rate: " << zRateCorrection
-                  << "\n";
+        if (logEvents) {
+            EV << "Offset: " << zOffsetCorrection << " Rate: " << zRateCorrection
+                      << "\n";
+        }
         delete msg;
     } else if (msg->isSelfMessage()
             && (msg->getKind() == STATIC_EVENT || msg->getKind() == DYNAMIC_EVENT)) {
@@ -292,7 +300,9 @@ void FRScheduler::dynamicFrameReceived(int64_t bitLength, unsigned int channel)
                 ceil(
                         (static_cast<double> (bitLength) / bandwidth)
                                 / gdMacrotick) / gdMinislot));
-    EV << "needed minislots: " << neededMinislots << "\n";
+    if (logEvents) {
+        EV << "needed minislots: " << neededMinislots << "\n";
+    }
     if (channel == 0) {
         additionalMinislotsChA += neededMinislots - 1;
     } else {
@@ -324,8 +334,10 @@ void FRScheduler::dynamicFrameReceived(int64_t bitLength, unsigned int channel)
                                         actionTimeEvent->getFrameID())
                                         + static_cast<unsigned int> (additionalMinislotsChB) * gdMinislot);
                     }
-                    EV << "getactiontime: " << actionTimeEvent->getAction_time()
-                              << "\n";
+                    if (logEvents) {
+                        EV << "getactiontime: " << actionTimeEvent->getAction_time()
+                                  << "\n";
+                    }
                     if ((actionTimeEvent->getAction_time())
                             <= getCycleTicks() - gdSymbolWindow - gdNIT
                                     - gdMinislot + gdMinislotActionPointOffset
@@ -22,6 +22,8 @@
 
 namespace FiCo4OMNeT {
 
+class FRSync;
+
 // TODO Documentation
 class FRScheduler : public cSimpleModule {
 	private:
@@ -55,6 +57,11 @@ class FRScheduler : public cSimpleModule {
          */
         cMessage* newCyclemsg;
 
+        /**
+         * @brief caches the synchronisation module of the node
+         */
+        FRSync *frSync;
+
         /**
          * @brief caches max_drift_change parameter
          */
@@ -143,6 +150,11 @@ class FRScheduler : public cSimpleModule {
          */
         double bandwidth; //[MBit/s]
 
+        /**
+         * @brief True if per-cycle and per-frame events are logged.
+         */
+        bool logEvents;
+
         /**
          * @brief number of microticks per cycle
          */
@@ -14,6 +14,9 @@
 //
 #include "fico4omnet/utilities/HelperFunctions.h"
 
+Register_GlobalConfigOption(CFGID_FICO4OMNET_HEADLESS, "fico4omnet-headless", CFG_BOOL, "false",
+        "Disables the visualization and the per-frame logging of the FiCo4OMNeT modules.");
+
 //Std
 #include <vector>
 
@@ -82,4 +85,46 @@ inline bool _isNetworkNode(cModule *mod)
     cProperties *props = mod->getProperties();
     return props && props->getAsBool("node");
 }
+
+bool isHeadless()
+{
+#ifdef FICO4OMNET_HEADLESS
+    return true;
+#else
+    return getEnvir()->getConfig()->getAsBool(CFGID_FICO4OMNET_HEADLESS);
+#endif
+}
+
+bool isVisualizationEnabled(const cComponent *component)
+{
+    return component->hasGUI() && !isHeadless();
+}
+
+simtime_t bitTime(double bandwidth)
+{
+    if (bandwidth <= 0)
+    {
+        throw cRuntimeError("The bandwidth must be positive but is %f.", bandwidth);
+    }
+    int64_t ticksPerSecond = 1;
+    for (int exp = SimTime::getScaleExp(); exp < 0; exp++)
+    {
+        ticksPerSecond *= 10;
+    }
+    int64_t bitsPerSecond = static_cast<int64_t>(bandwidth + 0.5);
+    simtime_t duration;
+    if (bitsPerSecond > 0 && static_cast<double>(bitsPerSecond) == bandwidth)
+    {
+        duration = SimTime::fromRaw((ticksPerSecond + bitsPerSecond / 2) / bitsPerSecond);
+    }
+    else
+    {
+        duration = SimTime(1 / bandwidth);
+    }
+    if (duration == SIMTIME_ZERO)
+    {
+        throw cRuntimeError("The bandwidth %f is too high for the resolution of the simulation time.", bandwidth);
+    }
+    return duration;
+}
 }
@@ -48,6 +48,58 @@ cModule *findModuleWhereverInNode(const char *name, cModule *from);
 
 inline bool _isNetworkNode(cModule *mod);
 
+/**
+ * @brief Returns the duration of one bit on a link with the given bandwidth.
+ *
+ * The duration is rounded once to the resolution of the simulation time. All frame and error timings
+ * are integer multiples of it and therefore free of floating point rounding.
+ *
+ * @param bandwidth bandwidth of the link in bit/s
+ * @return duration of one bit
+ */
+simtime_t bitTime(double bandwidth);
+
+/**
+ * @brief Returns whether the simulation runs headless.
+ *
+ * Headless runs skip all visualization and the logging on per-frame paths. This is the case if the library
+ * is compiled with FICO4OMNET_HEADLESS or if the configuration option fico4omnet-headless is set.
+ *
+ * @return true if the simulation runs headless
+ */
+bool isHeadless();
+
+/**
+ * @brief Returns whether the component should update display strings and show bubbles.
+ *
+ * @param component the component that wants to visualize its state
+ * @return true if a graphical environment is used and the simulation does not run headless
+ */
+bool isVisualizationEnabled(const cComponent *component);
+
+/**
+ * @brief Casts a module of the topology to the expected type.
+ *
+ * Used to resolve the modules a module interacts with once during the initialization.
+ *
+ * @param module the module to cast, may be nullptr
+ * @param description description of the expected module for the error message
+ * @param from the module that resolves the module
+ * @return the module with the expected type
+ * @throws cRuntimeError if the module does not exist or has the wrong type
+ */
+template<typename T>
+T* resolveModule(cModule *module, const char *description, const cModule *from)
+{
+    T *typedModule = dynamic_cast<T*>(module);
+    if (!typedModule)
+    {
+        throw cRuntimeError("Topology problem: %s of module %s could not be resolved!", description,
+                from->getFullPath().c_str());
+    }
+    return typedModule;
+}
+
 
 }
 
@@ -1,7 +1,7 @@
 #include "fico4omnet/utilities/ResultFilters.h"
 
 //Auto-generated messages
-#include "fico4omnet/linklayer/can/messages/CanDataFrame_m.h"
+#include "fico4omnet/linklayer/can/messages/CanDataFrame.h"
 #include "fico4omnet/linklayer/can/messages/ErrorFrame_m.h"
 #include "fico4omnet/linklayer/flexray/messages/FRFrame_m.h"
 